@@ -0,0 +1,149 @@
+#ifndef CAPTURE_FRAME_H
+#define CAPTURE_FRAME_H
+
+// ==============================
+// Waveform capture chunk format
+// ==============================
+//
+// Shared by the firmware (encoder) and tools/capture_to_csv (decoder); keep it
+// free of Arduino headers. One MQTT message = one chunk = header + samples.
+// Everything is little-endian; floats are IEEE-754 binary32.
+//
+//  off size field
+//    0    2 magic 'W' 'F'
+//    2    1 version (CAPTURE_FRAME_VERSION)
+//    3    1 channel index (CURRENT_CHANNELS row)
+//    4    2 captureId  (increments per capture request)
+//    6    2 seq        (0 .. chunkCount-1)
+//    8    2 chunkCount
+//   10    2 totalSamples in the capture
+//   12    2 firstIndex of this chunk's first sample
+//   14    2 sampleCount in this chunk
+//   16    2 nominal samples/s
+//   18    4 t0Us: micros() of sample 0
+//   22    4 spanUs: t(last) - t(first), gives the real sample period
+//   26    4 ampsPerCount
+//   30    4 offsetCounts (zero at capture time)
+//   34    2*sampleCount int16 raw counts
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+static constexpr uint8_t CAPTURE_MAGIC0 = 'W';
+static constexpr uint8_t CAPTURE_MAGIC1 = 'F';
+static constexpr uint8_t CAPTURE_FRAME_VERSION = 1;
+static constexpr size_t CAPTURE_HEADER_SIZE = 34;
+
+// 64 samples → 162-byte payload; with the topic this stays under
+// PubSubClient's default 256-byte packet buffer.
+static constexpr uint16_t CAPTURE_SAMPLES_PER_CHUNK = 64;
+static constexpr size_t CAPTURE_CHUNK_MAX = CAPTURE_HEADER_SIZE + 2 * CAPTURE_SAMPLES_PER_CHUNK;
+
+struct CaptureChunkHeader
+{
+    uint8_t version = CAPTURE_FRAME_VERSION;
+    uint8_t channel = 0;
+    uint16_t captureId = 0;
+    uint16_t seq = 0;
+    uint16_t chunkCount = 0;
+    uint16_t totalSamples = 0;
+    uint16_t firstIndex = 0;
+    uint16_t sampleCount = 0;
+    uint16_t sps = 0;
+    uint32_t t0Us = 0;
+    uint32_t spanUs = 0;
+    float ampsPerCount = 0.0f;
+    float offsetCounts = 0.0f;
+};
+
+namespace capture_detail
+{
+    inline void put16(uint8_t *p, uint16_t v)
+    {
+        p[0] = uint8_t(v);
+        p[1] = uint8_t(v >> 8);
+    }
+    inline void put32(uint8_t *p, uint32_t v)
+    {
+        put16(p, uint16_t(v));
+        put16(p + 2, uint16_t(v >> 16));
+    }
+    inline uint16_t get16(const uint8_t *p) { return uint16_t(p[0] | (p[1] << 8)); }
+    inline uint32_t get32(const uint8_t *p) { return get16(p) | (uint32_t(get16(p + 2)) << 16); }
+    inline void putF(uint8_t *p, float f)
+    {
+        uint32_t v;
+        memcpy(&v, &f, sizeof(v));
+        put32(p, v);
+    }
+    inline float getF(const uint8_t *p)
+    {
+        const uint32_t v = get32(p);
+        float f;
+        memcpy(&f, &v, sizeof(f));
+        return f;
+    }
+}
+
+// Writes header + samples into out (at least CAPTURE_HEADER_SIZE + 2*h.sampleCount bytes).
+// Returns the encoded length.
+inline size_t captureEncodeChunk(const CaptureChunkHeader &h, const int16_t *samples, uint8_t *out)
+{
+    using namespace capture_detail;
+    out[0] = CAPTURE_MAGIC0;
+    out[1] = CAPTURE_MAGIC1;
+    out[2] = h.version;
+    out[3] = h.channel;
+    put16(out + 4, h.captureId);
+    put16(out + 6, h.seq);
+    put16(out + 8, h.chunkCount);
+    put16(out + 10, h.totalSamples);
+    put16(out + 12, h.firstIndex);
+    put16(out + 14, h.sampleCount);
+    put16(out + 16, h.sps);
+    put32(out + 18, h.t0Us);
+    put32(out + 22, h.spanUs);
+    putF(out + 26, h.ampsPerCount);
+    putF(out + 30, h.offsetCounts);
+    uint8_t *p = out + CAPTURE_HEADER_SIZE;
+    for (uint16_t i = 0; i < h.sampleCount; ++i, p += 2)
+        put16(p, uint16_t(samples[i]));
+    return CAPTURE_HEADER_SIZE + 2u * h.sampleCount;
+}
+
+// Parses one chunk from buf. On success fills h, points samplesLE at the raw
+// sample bytes (use captureSampleAt) and returns the chunk's total length;
+// returns 0 on a bad magic/version or a truncated buffer.
+inline size_t captureDecodeChunk(const uint8_t *buf, size_t len, CaptureChunkHeader &h, const uint8_t *&samplesLE)
+{
+    using namespace capture_detail;
+    if (len < CAPTURE_HEADER_SIZE || buf[0] != CAPTURE_MAGIC0 || buf[1] != CAPTURE_MAGIC1 ||
+        buf[2] != CAPTURE_FRAME_VERSION)
+        return 0;
+    h.version = buf[2];
+    h.channel = buf[3];
+    h.captureId = get16(buf + 4);
+    h.seq = get16(buf + 6);
+    h.chunkCount = get16(buf + 8);
+    h.totalSamples = get16(buf + 10);
+    h.firstIndex = get16(buf + 12);
+    h.sampleCount = get16(buf + 14);
+    h.sps = get16(buf + 16);
+    h.t0Us = get32(buf + 18);
+    h.spanUs = get32(buf + 22);
+    h.ampsPerCount = getF(buf + 26);
+    h.offsetCounts = getF(buf + 30);
+    const size_t total = CAPTURE_HEADER_SIZE + 2u * h.sampleCount;
+    if (len < total)
+        return 0;
+    samplesLE = buf + CAPTURE_HEADER_SIZE;
+    return total;
+}
+
+inline int16_t captureSampleAt(const uint8_t *samplesLE, uint16_t i)
+{
+    return int16_t(capture_detail::get16(samplesLE + 2u * i));
+}
+
+#endif // CAPTURE_FRAME_H
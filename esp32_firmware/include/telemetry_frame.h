@@ -0,0 +1,232 @@
+#ifndef TELEMETRY_FRAME_H
+#define TELEMETRY_FRAME_H
+
+// ==============================
+// Packed telemetry frame format
+// ==============================
+//
+// One retained message on TOPIC_TELEMETRY_FRAME carrying every sensor and
+// status field, next to the per-value topics. Shared by the firmware
+// (encoder, status/frame_publisher) and host decoders (tools/telemetry_frame_dump,
+// the dashboard); keep it free of Arduino headers. Little-endian; floats are
+// IEEE-754 binary32. Probe / channel entries are in TEMP_PROBES /
+// CURRENT_CHANNELS row order.
+//
+// Header (TELEMETRY_FRAME_HEADER_SIZE bytes)
+//  off size field
+//    0    2 magic 'T' 'M'
+//    2    1 version (TELEMETRY_FRAME_VERSION)
+//    3    1 flags (TF_*)
+//    4    4 seq: +1 per frame since boot (a reset to 0 = the ESP rebooted)
+//    8    4 rtcSeconds (RTC local time, seconds since 1970)
+//   12    4 uptimeS
+//   16    2 heapKB free
+//   18    2 feedCount
+//   20    1 heatDutyPct: thermostat output 0..100, 255 = thermostat off
+//   21    1 tempCount
+//   22    1 currentCount
+//   23    1 reserved (0)
+// Then tempCount × 6 bytes
+//    0    2 int16 temperature, 0.01 °F (filtered)
+//    2    2 int16 slope, 0.01 °F/min
+//    4    1 flags (TFT_*)
+//    5    1 reserved (0)
+// Then currentCount × 10 bytes
+//    0    4 float amps (last RMS)
+//    4    4 float energy, Wh since the lamp counter was reset
+//    8    1 health (DriftDetector::Health: 0 learning, 1 ok, 2 degrading, 3 fail)
+//    9    1 flags (TFC_*)
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+static constexpr uint8_t TELEMETRY_MAGIC0 = 'T';
+static constexpr uint8_t TELEMETRY_MAGIC1 = 'M';
+static constexpr uint8_t TELEMETRY_FRAME_VERSION = 1;
+static constexpr size_t TELEMETRY_FRAME_HEADER_SIZE = 24;
+static constexpr size_t TELEMETRY_FRAME_TEMP_SIZE = 6;
+static constexpr size_t TELEMETRY_FRAME_CURRENT_SIZE = 10;
+static constexpr uint8_t TELEMETRY_FRAME_MAX_TEMPS = 8;
+static constexpr uint8_t TELEMETRY_FRAME_MAX_CURRENTS = 8;
+static constexpr size_t TELEMETRY_FRAME_MAX =
+    TELEMETRY_FRAME_HEADER_SIZE + TELEMETRY_FRAME_MAX_TEMPS * TELEMETRY_FRAME_TEMP_SIZE +
+    TELEMETRY_FRAME_MAX_CURRENTS * TELEMETRY_FRAME_CURRENT_SIZE;
+
+// Header flags
+static constexpr uint8_t TF_LIGHTS = 1u << 0;
+static constexpr uint8_t TF_HEAT = 1u << 1;
+static constexpr uint8_t TF_UV = 1u << 2;
+static constexpr uint8_t TF_AUTO_MODE = 1u << 3;
+static constexpr uint8_t TF_FEEDER_RUNNING = 1u << 4;
+static constexpr uint8_t TF_THERMOSTAT = 1u << 5;
+
+// Probe flags
+static constexpr uint8_t TFT_PRESENT = 1u << 0;
+static constexpr uint8_t TFT_OUTLIER = 1u << 1;
+static constexpr uint8_t TFT_RISE_ALARM = 1u << 2;
+
+// CT channel flags
+static constexpr uint8_t TFC_POWERED = 1u << 0; // its output is switched on
+static constexpr uint8_t TFC_ABOVE_THRESHOLD = 1u << 1;
+
+static constexpr uint8_t TF_HEAT_DUTY_NONE = 255;
+
+struct TelemetryFrameTemp
+{
+    float tempF = 0.0f;
+    float slopeFPerMin = 0.0f;
+    uint8_t flags = 0;
+};
+
+struct TelemetryFrameCurrent
+{
+    float amps = 0.0f;
+    float energyWh = 0.0f;
+    uint8_t health = 0;
+    uint8_t flags = 0;
+};
+
+struct TelemetryFrame
+{
+    uint8_t version = TELEMETRY_FRAME_VERSION;
+    uint8_t flags = 0;
+    uint32_t seq = 0;
+    uint32_t rtcSeconds = 0;
+    uint32_t uptimeS = 0;
+    uint16_t heapKB = 0;
+    uint16_t feedCount = 0;
+    uint8_t heatDutyPct = TF_HEAT_DUTY_NONE;
+    uint8_t tempCount = 0;
+    uint8_t currentCount = 0;
+    TelemetryFrameTemp temps[TELEMETRY_FRAME_MAX_TEMPS];
+    TelemetryFrameCurrent currents[TELEMETRY_FRAME_MAX_CURRENTS];
+};
+
+namespace telemetry_frame_detail
+{
+    inline void put16(uint8_t *p, uint16_t v)
+    {
+        p[0] = uint8_t(v);
+        p[1] = uint8_t(v >> 8);
+    }
+    inline void put32(uint8_t *p, uint32_t v)
+    {
+        put16(p, uint16_t(v));
+        put16(p + 2, uint16_t(v >> 16));
+    }
+    inline uint16_t get16(const uint8_t *p) { return uint16_t(p[0] | (p[1] << 8)); }
+    inline uint32_t get32(const uint8_t *p) { return get16(p) | (uint32_t(get16(p + 2)) << 16); }
+    inline void putF(uint8_t *p, float f)
+    {
+        uint32_t v;
+        memcpy(&v, &f, sizeof(v));
+        put32(p, v);
+    }
+    inline float getF(const uint8_t *p)
+    {
+        const uint32_t v = get32(p);
+        float f;
+        memcpy(&f, &v, sizeof(f));
+        return f;
+    }
+    // Fixed-point 0.01, saturating
+    inline void putCenti(uint8_t *p, float v)
+    {
+        float c = v * 100.0f;
+        c = c > 32767.0f ? 32767.0f : (c < -32768.0f ? -32768.0f : c);
+        put16(p, uint16_t(int16_t(c < 0 ? c - 0.5f : c + 0.5f)));
+    }
+    inline float getCenti(const uint8_t *p) { return int16_t(get16(p)) / 100.0f; }
+}
+
+inline size_t telemetryFrameSize(uint8_t tempCount, uint8_t currentCount)
+{
+    return TELEMETRY_FRAME_HEADER_SIZE + tempCount * TELEMETRY_FRAME_TEMP_SIZE +
+           currentCount * TELEMETRY_FRAME_CURRENT_SIZE;
+}
+
+// Writes the frame into out (at least TELEMETRY_FRAME_MAX bytes).
+// Returns the encoded length, 0 if the counts exceed the format's maxima.
+inline size_t telemetryEncodeFrame(const TelemetryFrame &f, uint8_t *out)
+{
+    using namespace telemetry_frame_detail;
+    if (f.tempCount > TELEMETRY_FRAME_MAX_TEMPS || f.currentCount > TELEMETRY_FRAME_MAX_CURRENTS)
+        return 0;
+    out[0] = TELEMETRY_MAGIC0;
+    out[1] = TELEMETRY_MAGIC1;
+    out[2] = f.version;
+    out[3] = f.flags;
+    put32(out + 4, f.seq);
+    put32(out + 8, f.rtcSeconds);
+    put32(out + 12, f.uptimeS);
+    put16(out + 16, f.heapKB);
+    put16(out + 18, f.feedCount);
+    out[20] = f.heatDutyPct;
+    out[21] = f.tempCount;
+    out[22] = f.currentCount;
+    out[23] = 0;
+
+    uint8_t *p = out + TELEMETRY_FRAME_HEADER_SIZE;
+    for (uint8_t i = 0; i < f.tempCount; ++i, p += TELEMETRY_FRAME_TEMP_SIZE)
+    {
+        putCenti(p, f.temps[i].tempF);
+        putCenti(p + 2, f.temps[i].slopeFPerMin);
+        p[4] = f.temps[i].flags;
+        p[5] = 0;
+    }
+    for (uint8_t i = 0; i < f.currentCount; ++i, p += TELEMETRY_FRAME_CURRENT_SIZE)
+    {
+        putF(p, f.currents[i].amps);
+        putF(p + 4, f.currents[i].energyWh);
+        p[8] = f.currents[i].health;
+        p[9] = f.currents[i].flags;
+    }
+    return size_t(p - out);
+}
+
+// Parses one frame from buf. Returns its length, or 0 on a bad magic/version,
+// counts beyond the maxima or a truncated buffer.
+inline size_t telemetryDecodeFrame(const uint8_t *buf, size_t len, TelemetryFrame &f)
+{
+    using namespace telemetry_frame_detail;
+    if (len < TELEMETRY_FRAME_HEADER_SIZE || buf[0] != TELEMETRY_MAGIC0 || buf[1] != TELEMETRY_MAGIC1 ||
+        buf[2] != TELEMETRY_FRAME_VERSION)
+        return 0;
+    const uint8_t tempCount = buf[21];
+    const uint8_t currentCount = buf[22];
+    if (tempCount > TELEMETRY_FRAME_MAX_TEMPS || currentCount > TELEMETRY_FRAME_MAX_CURRENTS)
+        return 0;
+    const size_t total = telemetryFrameSize(tempCount, currentCount);
+    if (len < total)
+        return 0;
+
+    f.version = buf[2];
+    f.flags = buf[3];
+    f.seq = get32(buf + 4);
+    f.rtcSeconds = get32(buf + 8);
+    f.uptimeS = get32(buf + 12);
+    f.heapKB = get16(buf + 16);
+    f.feedCount = get16(buf + 18);
+    f.heatDutyPct = buf[20];
+    f.tempCount = tempCount;
+    f.currentCount = currentCount;
+
+    const uint8_t *p = buf + TELEMETRY_FRAME_HEADER_SIZE;
+    for (uint8_t i = 0; i < tempCount; ++i, p += TELEMETRY_FRAME_TEMP_SIZE)
+    {
+        f.temps[i].tempF = getCenti(p);
+        f.temps[i].slopeFPerMin = getCenti(p + 2);
+        f.temps[i].flags = p[4];
+    }
+    for (uint8_t i = 0; i < currentCount; ++i, p += TELEMETRY_FRAME_CURRENT_SIZE)
+    {
+        f.currents[i].amps = getF(p);
+        f.currents[i].energyWh = getF(p + 4);
+        f.currents[i].health = p[8];
+        f.currents[i].flags = p[9];
+    }
+    return total;
+}
+
+#endif // TELEMETRY_FRAME_H
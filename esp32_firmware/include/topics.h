@@ -5,85 +5,135 @@
 // MQTT Topic Map (Scalable)
 // ==============================
 //
-// Root namespace: change once here to rename everything (e.g., "turtle/" or "turtle/tank1/").
-// Use trailing slash!
-#define TOPIC_ROOT "turtle/"
+// Every topic below is relative to the device's topic root. The root is a
+// runtime setting (NVS "device"/"root", see mqtt/device_config.h); MqttManager
+// puts it in front of everything it publishes or subscribes to and strips it
+// from inbound messages, so one image serves any number of tanks
+// (e.g. "turtle/" or "turtle/tank2/").
+#define TOPIC_ROOT_DEFAULT "turtle/" // trailing slash!
 
 // ------------------------------
 // Sensors (telemetry only)
 // ------------------------------
 // Temperatures
-#define TOPIC_TEMP_BASKING TOPIC_ROOT "sensors/temp/basking" // float/number
-#define TOPIC_TEMP_WATER TOPIC_ROOT "sensors/temp/water"     // float/number
+#define TOPIC_TEMP_BASKING "sensors/temp/basking" // float/number
+#define TOPIC_TEMP_WATER "sensors/temp/water"     // float/number
+#define TOPIC_TEMP_COOL "sensors/temp/cool"       // float/number (cool side)
+#define TOPIC_TEMP_AMBIENT "sensors/temp/ambient" // float/number (room)
+// Per-probe subtopics derived from the probe topic (Temp_sensor/temp_probes.h):
+//   <topic>/status "OK"/"DISCONNECTED"/"UNASSIGNED", <topic>/rom 16 hex digits,
+//   <topic>/errors {"reads","crc","por","disconnects","outliers"},
+//   <topic>/slope °F/min (filtered), <topic>/alarm "OK"/"RISE" (rate-of-rise, immediate)
+#define TOPIC_TEMP_PROBES_CMD "sensors/temp/probes/cmd" // "rescan" / {"assign":"water","rom":"28..."}
 
 // Currents (for devices that draw power)
-#define TOPIC_CURRENT_HEAT TOPIC_ROOT "sensors/current/heat" // float/number (amps)
-#define TOPIC_CURRENT_UV TOPIC_ROOT "sensors/current/uv"     // float/number (amps)
+#define TOPIC_CURRENT_HEAT "sensors/current/heat" // float/number (amps)
+#define TOPIC_CURRENT_UV "sensors/current/uv"     // float/number (amps)
 
-#define TOPIC_CURRENT_HEAT_STATUS TOPIC_ROOT "sensors/current/heat/status"  //  "OK"/"FLT"
-#define TOPIC_CURRENT_UV_STATUS TOPIC_ROOT "sensors/current/uv/status"  //  "OK"/"FLT"
+#define TOPIC_CURRENT_HEAT_STATUS "sensors/current/heat/status"  //  "OK"/"FLT"
+#define TOPIC_CURRENT_UV_STATUS "sensors/current/uv/status"  //  "OK"/"FLT"
+// Per-channel subtopics are derived from the channel topic (current_channels.h):
+//   <topic>/status "OK"/"FLT"/"OFF", <topic>/peak amps, <topic>/crest peak/rms,
+//   <topic>/baseline {"counts","conf"}, <topic>/health "OK"/"DEGRADING"/"FAIL"/"LEARNING",
+//   <topic>/energy_wh total Wh, <topic>/on_seconds lamp-on seconds (bulb life),
+//   <topic>/capture binary waveform chunks (format: capture_frame.h),
+//   <topic>/harmonics {"f1","h3","h5","h7"} RMS amps + "thd" %
+#define TOPIC_CURRENT_CAPTURE_CMD "sensors/current/capture/cmd"       // "all" / "heat" / {"channel":"uv","cycles":12}
+#define TOPIC_CURRENT_CAPTURE_STATUS "sensors/current/capture/status" // "recording:<ch>"/"done:<ch>"/"error:..."
 // (Add more later, e.g.)
-// #define TOPIC_CURRENT_PUMP    TOPIC_ROOT "sensors/current/pump"
-// #define TOPIC_HUMIDITY_AIR    TOPIC_ROOT "sensors/humidity/air"
+// #define TOPIC_CURRENT_PUMP    "sensors/current/pump"
+// #define TOPIC_HUMIDITY_AIR    "sensors/humidity/air"
 
 // ------------------------------
 // Lights (device state + control)
 // ------------------------------
-#define TOPIC_LIGHTS_STATUS TOPIC_ROOT "lights/status"             // "ON"/"OFF" (retained)
-#define TOPIC_LIGHTS_CMD TOPIC_ROOT "lights/cmd"                   // "ON"/"OFF" (manual override)
-#define TOPIC_LIGHTS_SCHEDULE TOPIC_ROOT "lights/schedule"         // JSON {"on":"HH:MM","off":"HH:MM"} (retained)
-#define TOPIC_LIGHTS_SCHEDULE_CMD TOPIC_ROOT "lights/schedule/cmd" // JSON {"on":"HH:MM","off":"HH:MM"}
+#define TOPIC_LIGHTS_STATUS "lights/status"             // "ON"/"OFF" (retained)
+#define TOPIC_LIGHTS_CMD "lights/cmd"                   // "ON"/"OFF" (manual override)
+#define TOPIC_LIGHTS_SCHEDULE "lights/schedule"         // JSON {"on":"HH:MM","off":"HH:MM"} (retained)
+#define TOPIC_LIGHTS_SCHEDULE_CMD "lights/schedule/cmd" // JSON {"on":"HH:MM","off":"HH:MM"}
 
 // Optional per‑channel states
 // Per-channel
-#define TOPIC_HEAT_STATUS TOPIC_ROOT "lights/heat/status"
-#define TOPIC_HEAT_CMD TOPIC_ROOT "lights/heat/cmd"
-#define TOPIC_UV_STATUS TOPIC_ROOT "lights/uv/status"
-#define TOPIC_UV_CMD TOPIC_ROOT "lights/uv/cmd"
+#define TOPIC_HEAT_STATUS "lights/heat/status"
+#define TOPIC_HEAT_CMD "lights/heat/cmd"
+// Heat-lamp thermostat (auto mode, inside the schedule window)
+#define TOPIC_HEAT_THERMOSTAT "lights/heat/thermostat"         // JSON {"enabled","setpoint","kp","ki","kd","duty","temp","mode"} (retained)
+#define TOPIC_HEAT_THERMOSTAT_CMD "lights/heat/thermostat/cmd" // JSON, any subset of {"enabled","setpoint","kp","ki","kd"}
+#define TOPIC_UV_STATUS "lights/uv/status"
+#define TOPIC_UV_CMD "lights/uv/cmd"
 
 // ------------------------------
 // Feeder (device state + control)
 // ------------------------------
-#define TOPIC_FEEDER_STATE TOPIC_ROOT "feeder/state" // "IDLE"/"RUNNING" (retained)
-#define TOPIC_FEEDER_COUNT TOPIC_ROOT "feeder/count" // integer (retained)
-#define TOPIC_FEEDER_CMD TOPIC_ROOT "feeder/cmd"     // "feed" or "1"
+#define TOPIC_FEEDER_STATE "feeder/state" // "IDLE"/"RUNNING" (retained)
+#define TOPIC_FEEDER_COUNT "feeder/count" // integer (retained)
+#define TOPIC_FEEDER_CMD "feeder/cmd"     // "feed" or "1"
 
 // ------------------------------
 // Auto Mode (mode state + control)
 // ------------------------------
-#define TOPIC_AUTO_MODE_STATUS TOPIC_ROOT "auto_mode/status" // "on"/"off" (retained)
-#define TOPIC_AUTO_MODE_CMD TOPIC_ROOT "auto_mode/cmd"       // "on"/"off"
+#define TOPIC_AUTO_MODE_STATUS "auto_mode/status" // "on"/"off" (retained)
+#define TOPIC_AUTO_MODE_CMD "auto_mode/cmd"       // "on"/"off"
 
 // ------------------------------
 // ESP / Health (telemetry only)
 // ------------------------------
-#define TOPIC_ESP_IP TOPIC_ROOT "esp/ip"            // "192.168.x.x" (retained)
-#define TOPIC_ESP_HEAP TOPIC_ROOT "esp/heap"        // integer bytes
-#define TOPIC_ESP_UPTIME TOPIC_ROOT "esp/uptime_ms" // integer ms
-#define TOPIC_ESP_MQTT TOPIC_ROOT "esp/mqtt"        // "connected"/"reconnected"/...
-#define TOPIC_REBOOT_CMD TOPIC_ROOT "reboot/cmd"
+#define TOPIC_ESP_IP "esp/ip"            // "192.168.x.x" (retained)
+#define TOPIC_ESP_HEAP "esp/heap"        // integer bytes
+#define TOPIC_ESP_UPTIME "esp/uptime_ms" // integer ms
+#define TOPIC_ESP_MQTT "esp/mqtt"        // "connected"/"reconnected"/...
+#define TOPIC_ESP_TELEMETRY "esp/telemetry" // {"sent","suppressed","coalesced","dropped"} publish counters
+#define TOPIC_ESP_REPLAY "esp/replay"       // {"state","depth","bytes","replayed","dropped","rate"} store-and-forward (retained)
+#define TOPIC_ESP_LINK "esp/link"           // reconnect counters: drops by cause, attempts, "ttr_ms" time to reconnect (retained)
+#define TOPIC_ESP_CMD_LATENCY "esp/cmd_latency" // {"n","p50_us","p99_us","max_us","nacks"} receipt → actuation (retained)
+#define TOPIC_ESP_SAMPLING "esp/sampling"   // {"wakes","max_busy_us","onewire_max_us","overruns"} acquisition tasks (retained)
+#define TOPIC_REBOOT_CMD "reboot/cmd"
+
+// ------------------------------
+// Command acknowledgements
+// ------------------------------
+// Any */cmd topic also takes an envelope: {"id":"abc","cmd":"on"} for token
+// commands, or "id" next to the usual fields for JSON ones. With an id, the
+// result is published here (not retained):
+//   {"id","topic","ok":true,"reason":"applied","rx_ms","act_ms","lat_us"}
+//   {"id","topic","ok":false,"reason":"auto_mode"|"bad_payload"|"busy"|"unknown_channel"|"rejected","rx_ms"}
+// rx_ms/act_ms = device uptime at receipt (network task) and actuation.
+#define TOPIC_CMD_ACK "cmd/ack"
+
+// Packed frame with every sensor + status field (include/telemetry_frame.h), retained
+#define TOPIC_TELEMETRY_FRAME "telemetry/frame"
+
+// Store-and-forward replay: records logged during a broker outage, oldest first.
+// {"r":[[ts,"name",value],...],"left":N}; ts = RTC seconds, name = TEMP_PROBES /
+// CURRENT_CHANNELS name, value °F or A. Not retained; may repeat after a reboot.
+#define TOPIC_TELEMETRY_REPLAY "replay/telemetry"
 
 // (Optional) RTC/time control endpoints if you want them later:
-// #define TOPIC_RTC_TIME        TOPIC_ROOT "rtc/time"               // publish current HH:MM:SS (retained)
-// #define TOPIC_RTC_SYNC_CMD    TOPIC_ROOT "rtc/sync/cmd"           // trigger NTP sync
+// #define TOPIC_RTC_TIME        "rtc/time"               // publish current HH:MM:SS (retained)
+// #define TOPIC_RTC_SYNC_CMD    "rtc/sync/cmd"           // trigger NTP sync
 
 // ── Group: commands to SUBSCRIBE to (UI → ESP) ───────────────────────
 static const char *const SUBSCRIBE_TOPICS[] = {
     TOPIC_LIGHTS_CMD,
     TOPIC_LIGHTS_SCHEDULE_CMD,
     TOPIC_HEAT_CMD,
+    TOPIC_HEAT_THERMOSTAT_CMD,
     TOPIC_UV_CMD,
     TOPIC_FEEDER_CMD,
-    TOPIC_AUTO_MODE_CMD
+    TOPIC_AUTO_MODE_CMD,
+    TOPIC_CURRENT_CAPTURE_CMD,
+    TOPIC_TEMP_PROBES_CMD
     // , TOPIC_REBOOT_CMD
 };
 static const size_t SUBSCRIBE_COUNT =
     sizeof(SUBSCRIBE_TOPICS) / sizeof(SUBSCRIBE_TOPICS[0]);
 
-// (Optional) Wildcards; use these instead of the list above if you prefer
+// (Optional) Wildcards; use these instead of the list above if you prefer.
+// Relative like everything else, so they only match this device's root.
 static const char *const SUBSCRIBE_WILDCARDS[] = {
-    TOPIC_ROOT "+/cmd",  // feeder/cmd, lights/cmd, auto_mode/cmd
-    TOPIC_ROOT "+/+/cmd" // lights/heat/cmd, lights/uv/cmd, lights/schedule/cmd
+    "+/cmd",  // feeder/cmd, lights/cmd, auto_mode/cmd
+    "+/+/cmd", // lights/heat/cmd, lights/uv/cmd, lights/schedule/cmd
+    "+/+/+/cmd" // lights/heat/thermostat/cmd, sensors/temp/probes/cmd, ...
 };
 static const size_t SUBSCRIBE_WILDCARDS_COUNT =
     sizeof(SUBSCRIBE_WILDCARDS) / sizeof(SUBSCRIBE_WILDCARDS[0]);
@@ -0,0 +1,211 @@
+#include "ds18b20_bus.h"
+
+void Ds18b20Bus::begin(uint8_t pin)
+{
+    wire.begin(pin);
+}
+
+void Ds18b20Bus::bind(uint8_t slot, const uint8_t rom[8])
+{
+    if (slot >= MAX_PROBES)
+        return;
+    Probe &p = probes[slot];
+    if (p.bound && memcmp(p.rom, rom, 8) == 0)
+        return; // same probe: keep its counters
+
+    // Different physical probe: its history does not carry over
+    const uint8_t bits = p.bits;
+    p = Probe();
+    memcpy(p.rom, rom, 8);
+    p.bound = true;
+    p.bits = bits;
+    p.configPending = bits != DEFAULT_BITS;
+}
+
+void Ds18b20Bus::unbind(uint8_t slot)
+{
+    if (slot >= MAX_PROBES)
+        return;
+    const uint8_t bits = probes[slot].bits;
+    probes[slot] = Probe();
+    probes[slot].bits = bits;
+}
+
+void Ds18b20Bus::setResolution(uint8_t slot, uint8_t bits)
+{
+    if (slot >= MAX_PROBES)
+        return;
+    bits = bits < 9 ? 9 : bits > 12 ? 12 : bits;
+    Probe &p = probes[slot];
+    if (p.bits == bits)
+        return;
+    p.bits = bits;
+    p.configPending = p.bound;
+}
+
+bool Ds18b20Bus::configureNext()
+{
+    for (Probe &p : probes)
+    {
+        if (!p.bound || !p.configPending)
+            continue;
+        p.configPending = false;
+        if (!wire.reset())
+            return true; // retried after the next mismatched read
+        wire.select(p.rom);
+        wire.write(CMD_WRITE_SCRATCHPAD);
+        wire.write(0x7F); // TH / TL: alarm search unused
+        wire.write(0x80);
+        wire.write(configFor(p.bits));
+        return true;
+    }
+    return false;
+}
+
+unsigned long Ds18b20Bus::conversionWindowMs() const
+{
+    uint8_t maxBits = 9;
+    for (const Probe &p : probes)
+    {
+        if (p.bound && p.bits > maxBits)
+            maxBits = p.bits;
+    }
+    return conversionMs(maxBits);
+}
+
+int Ds18b20Bus::findSlot(const uint8_t rom[8]) const
+{
+    for (uint8_t i = 0; i < MAX_PROBES; ++i)
+    {
+        if (probes[i].bound && memcmp(probes[i].rom, rom, 8) == 0)
+            return i;
+    }
+    return -1;
+}
+
+uint8_t Ds18b20Bus::search(uint8_t (*roms)[8], uint8_t maxRoms)
+{
+    uint8_t n = 0;
+    uint8_t rom[8];
+    wire.reset_search();
+    while (n < maxRoms && wire.search(rom))
+    {
+        if (romValid(rom))
+            memcpy(roms[n++], rom, 8);
+    }
+    wire.reset_search();
+    return n;
+}
+
+bool Ds18b20Bus::startConversion()
+{
+    if (!wire.reset())
+        return false; // no presence pulse: bus open or shorted
+    wire.skip();
+    wire.write(CMD_CONVERT_T);
+    return true;
+}
+
+bool Ds18b20Bus::readProbe(uint8_t slot)
+{
+    if (slot >= MAX_PROBES || !probes[slot].bound)
+        return false;
+    Probe &p = probes[slot];
+
+    if (!wire.reset())
+    {
+        miss_(p);
+        return false;
+    }
+    wire.select(p.rom);
+    wire.write(CMD_READ_SCRATCHPAD);
+    uint8_t sp[9];
+    wire.read_bytes(sp, sizeof(sp));
+
+    // Nobody drove the bus: addressed probe is gone (pull-up reads all 1s)
+    bool allOnes = true;
+    for (uint8_t b : sp)
+        allOnes &= (b == 0xFF);
+    if (allOnes)
+    {
+        miss_(p);
+        return false;
+    }
+
+    if (OneWireBus::crc8(sp, 8) != sp[8])
+    {
+        ++p.crcErrors;
+        return false;
+    }
+
+    int16_t raw = int16_t((sp[1] << 8) | sp[0]);
+    if (raw == 0x0550 && sp[6] == 0x0C)
+    {
+        ++p.porErrors; // 85.0 °C reset value: the probe lost power before converting
+        p.configPending = p.bits != DEFAULT_BITS; // and its scratchpad config with it
+        return false;
+    }
+
+    // Below 12 bit the low LSBs are undefined; the result is still 1/16 °C
+    const uint8_t bits = bitsFromConfig(sp[4]);
+    raw &= int16_t(~((1 << (12 - bits)) - 1));
+    if (bits != p.bits)
+        p.configPending = true;
+
+    p.raw = raw;
+    p.misses = 0;
+    p.present = true;
+    ++p.reads;
+    return true;
+}
+
+void Ds18b20Bus::miss_(Probe &p)
+{
+    if (p.misses < 0xFF)
+        ++p.misses;
+    if (p.present && p.misses >= MISSES_BEFORE_DISCONNECT)
+    {
+        p.present = false;
+        ++p.disconnects;
+    }
+}
+
+bool Ds18b20Bus::romValid(const uint8_t rom[8])
+{
+    return rom[0] == FAMILY_DS18B20 && OneWireBus::crc8(rom, 7) == rom[7];
+}
+
+void Ds18b20Bus::romToHex(const uint8_t rom[8], char out[17])
+{
+    static const char HEX_DIGITS[] = "0123456789ABCDEF";
+    for (uint8_t i = 0; i < 8; ++i)
+    {
+        out[2 * i] = HEX_DIGITS[rom[i] >> 4];
+        out[2 * i + 1] = HEX_DIGITS[rom[i] & 0x0F];
+    }
+    out[16] = '\0';
+}
+
+bool Ds18b20Bus::hexToRom(const char *hex, uint8_t rom[8])
+{
+    if (!hex || strlen(hex) != 16)
+        return false;
+    for (uint8_t i = 0; i < 16; ++i)
+    {
+        const char c = hex[i];
+        uint8_t v;
+        if (c >= '0' && c <= '9')
+            v = c - '0';
+        else if (c >= 'a' && c <= 'f')
+            v = c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F')
+            v = c - 'A' + 10;
+        else
+            return false;
+        if (i & 1)
+            rom[i / 2] |= v;
+        else
+            rom[i / 2] = uint8_t(v << 4);
+    }
+    return romValid(rom);
+}
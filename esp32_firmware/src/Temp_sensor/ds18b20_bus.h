@@ -0,0 +1,103 @@
+#ifndef DS18B20_BUS_H
+#define DS18B20_BUS_H
+
+#include <Arduino.h>
+
+// OneWire backend, chosen at build time. The default bit-bangs each slot with
+// interrupts masked; -DONEWIRE_RMT=1 times slots on the RMT peripheral instead
+// (onewire_rmt.h) and keeps interrupts live during bus traffic.
+#if ONEWIRE_RMT
+#include "onewire_rmt.h"
+using OneWireBus = OneWireRmt;
+#else
+#include <OneWire.h>
+using OneWireBus = OneWire;
+#endif
+
+// Many DS18B20s on one OneWire bus, driven directly (no DallasTemperature):
+// one Skip-ROM "Convert T" for every probe, then one addressed scratchpad read
+// per probe with CRC check. Probes live in fixed slots bound to a ROM code;
+// the owner decides where ROMs come from (NVS cache or search()).
+// Each slot has its own resolution (9..12 bit); the convert wait follows the
+// slowest bound probe and ends early once the bus reads "done" (needs VDD-powered
+// probes: a parasite-powered probe cannot answer read slots while converting).
+class Ds18b20Bus
+{
+public:
+    static constexpr uint8_t MAX_PROBES = 8;
+    static constexpr uint8_t FAMILY_DS18B20 = 0x28;
+    static constexpr uint8_t MISSES_BEFORE_DISCONNECT = 3;
+    static constexpr uint8_t DEFAULT_BITS = 12;
+
+    // Datasheet max conversion time: 93.75 ms at 9 bit, doubling per bit
+    static constexpr unsigned long conversionMs(uint8_t bits)
+    {
+        return bits <= 9 ? 94 : bits == 10 ? 188 : bits == 11 ? 375 : 750;
+    }
+
+    struct Probe
+    {
+        uint8_t rom[8] = {0};
+        bool bound = false;
+        bool present = false;
+        int16_t raw = 0; // last good reading, 1/16 °C (undefined low bits cleared)
+        uint8_t bits = DEFAULT_BITS; // slot setting, survives rebinding
+        bool configPending = false;  // scratchpad config must be (re)written
+        uint8_t misses = 0;
+        uint32_t reads = 0;       // good scratchpad reads
+        uint32_t crcErrors = 0;   // scratchpad CRC mismatch
+        uint32_t porErrors = 0;   // 85 °C power-on value (probe browned out)
+        uint32_t disconnects = 0; // present → missing transitions
+    };
+
+    void begin(uint8_t pin);
+
+    // Slot binding
+    void bind(uint8_t slot, const uint8_t rom[8]);
+    void unbind(uint8_t slot);
+    int findSlot(const uint8_t rom[8]) const; // -1 if not bound
+    const Probe &probe(uint8_t slot) const { return probes[slot < MAX_PROBES ? slot : 0]; }
+
+    // Resolution (9..12 bit). Written to the probe's scratchpad, not its EEPROM;
+    // a probe that power-cycles comes back at its EEPROM setting and is rewritten
+    // when a read shows the mismatch.
+    void setResolution(uint8_t slot, uint8_t bits);
+    // Writes one pending config per call; false when nothing was pending
+    bool configureNext();
+    // Convert wait for the slowest bound probe
+    unsigned long conversionWindowMs() const;
+
+    // Full bus search; copies up to maxRoms CRC-valid DS18B20 ROMs, returns count
+    uint8_t search(uint8_t (*roms)[8], uint8_t maxRoms);
+
+    // Skip-ROM + Convert T: every probe converts at once. False if nobody answered reset.
+    bool startConversion();
+    // Read slot after Convert T: probes hold the bus low until every one is done
+    bool conversionDone() { return wire.read_bit() != 0; }
+
+    // Addressed scratchpad read of one slot. Updates raw/present and the counters;
+    // returns true on a good (CRC-valid, non power-on) reading.
+    bool readProbe(uint8_t slot);
+
+    static bool romValid(const uint8_t rom[8]);
+    static float toC(int16_t raw) { return raw / 16.0f; }
+    static void romToHex(const uint8_t rom[8], char out[17]);
+    static bool hexToRom(const char *hex, uint8_t rom[8]);
+
+private:
+    OneWireBus wire;
+    Probe probes[MAX_PROBES];
+
+    void miss_(Probe &p);
+
+    // DS18B20 function commands
+    static constexpr uint8_t CMD_CONVERT_T = 0x44;
+    static constexpr uint8_t CMD_READ_SCRATCHPAD = 0xBE;
+    static constexpr uint8_t CMD_WRITE_SCRATCHPAD = 0x4E;
+
+    // Config register: R1 R0 in bits 6..5, others read as 1
+    static constexpr uint8_t configFor(uint8_t bits) { return uint8_t(((bits - 9) << 5) | 0x1F); }
+    static constexpr uint8_t bitsFromConfig(uint8_t cfg) { return uint8_t(((cfg >> 5) & 0x03) + 9); }
+};
+
+#endif // DS18B20_BUS_H
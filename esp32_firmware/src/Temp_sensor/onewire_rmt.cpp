@@ -0,0 +1,225 @@
+#include "onewire_rmt.h"
+
+#if ONEWIRE_RMT
+
+#include <driver/gpio.h>
+#include <esp_rom_gpio.h>
+#include <soc/rmt_periph.h>
+
+void OneWireRmt::begin(uint8_t pin, rmt_channel_t txChannel, rmt_channel_t rxChannel)
+{
+    txCh = txChannel;
+    rxCh = rxChannel;
+
+    // 1 µs ticks from the 80 MHz APB clock
+    rmt_config_t tx = RMT_DEFAULT_CONFIG_TX(gpio_num_t(pin), txCh);
+    tx.clk_div = 80;
+    tx.tx_config.idle_level = RMT_IDLE_LEVEL_HIGH; // released
+    tx.tx_config.idle_output_en = true;
+    tx.tx_config.carrier_en = false;
+    tx.tx_config.loop_en = false;
+
+    rmt_config_t rx = RMT_DEFAULT_CONFIG_RX(gpio_num_t(pin), rxCh);
+    rx.clk_div = 80;
+    rx.rx_config.filter_en = true;
+    rx.rx_config.filter_ticks_thresh = 30; // APB cycles: drops < ~0.4 µs glitches
+    rx.rx_config.idle_threshold = OW_RX_IDLE_US;
+
+    if (rmt_config(&tx) != ESP_OK || rmt_driver_install(txCh, 0, 0) != ESP_OK ||
+        rmt_config(&rx) != ESP_OK || rmt_driver_install(rxCh, 512, 0) != ESP_OK ||
+        rmt_get_ringbuf_handle(rxCh, &rxRing) != ESP_OK)
+    {
+        Serial.println("[OneWire] RMT init failed");
+        return;
+    }
+
+    // rmt_config() routed the pin as plain output / plain input for each
+    // channel; make it one open-drain pad that drives TX and feeds RX
+    gpio_set_pull_mode(gpio_num_t(pin), GPIO_PULLUP_ONLY);
+    gpio_set_direction(gpio_num_t(pin), GPIO_MODE_INPUT_OUTPUT_OD);
+    esp_rom_gpio_connect_out_signal(pin, rmt_periph_signals.groups[0].channels[txCh].tx_sig, false, false);
+    esp_rom_gpio_connect_in_signal(pin, rmt_periph_signals.groups[0].channels[rxCh].rx_sig, false);
+    ready = true;
+}
+
+size_t OneWireRmt::transact_(const OwPulse *tx, size_t n, OwPulse *rx)
+{
+    if (!ready || n > MAX_PULSES)
+        return 0;
+
+    rmt_item32_t items[MAX_PULSES];
+    for (size_t i = 0; i < n; ++i)
+    {
+        items[i].level0 = 0;
+        items[i].duration0 = tx[i].lowUs;
+        items[i].level1 = 1;
+        items[i].duration1 = tx[i].highUs;
+    }
+
+    if (rx)
+    {
+        // Drop anything a previous (timed-out) capture left behind
+        size_t len = 0;
+        while (void *stale = xRingbufferReceive(rxRing, &len, 0))
+            vRingbufferReturnItem(rxRing, stale);
+        rmt_rx_start(rxCh, true);
+    }
+
+    if (rmt_write_items(txCh, items, int(n), true) != ESP_OK)
+    {
+        if (rx)
+            rmt_rx_stop(rxCh);
+        return 0;
+    }
+    if (!rx)
+        return n;
+
+    // Capture closes OW_RX_IDLE_US after the last slot
+    size_t bytes = 0;
+    auto *got = static_cast<rmt_item32_t *>(xRingbufferReceive(rxRing, &bytes, pdMS_TO_TICKS(RX_TIMEOUT_MS)));
+    rmt_rx_stop(rxCh);
+    if (!got)
+        return 0;
+
+    size_t count = 0;
+    for (size_t i = 0; i < bytes / sizeof(rmt_item32_t) && count < MAX_PULSES; ++i)
+    {
+        if (got[i].level0 != 0)
+            continue; // capture starts on a falling edge; anything else is noise
+        rx[count].lowUs = uint16_t(got[i].duration0);
+        rx[count].highUs = got[i].level1 ? uint16_t(got[i].duration1) : 0;
+        ++count;
+    }
+    vRingbufferReturnItem(rxRing, got);
+    return count;
+}
+
+uint8_t OneWireRmt::reset()
+{
+    const OwPulse tx = owResetPulse();
+    OwPulse rx[MAX_PULSES];
+    const size_t n = transact_(&tx, 1, rx);
+    return owDecodePresence(rx, n) ? 1 : 0;
+}
+
+void OneWireRmt::write(uint8_t v, uint8_t /*power*/)
+{
+    OwPulse tx[8];
+    transact_(tx, owEncodeByte(v, tx));
+}
+
+uint8_t OneWireRmt::read()
+{
+    OwPulse tx[8];
+    for (OwPulse &p : tx)
+        p = owReadSlot();
+    OwPulse rx[MAX_PULSES];
+    uint8_t v = 0xFF; // an idle bus reads all ones
+    owDecodeByte(rx, transact_(tx, 8, rx), v);
+    return v;
+}
+
+void OneWireRmt::read_bytes(uint8_t *buf, uint16_t count)
+{
+    for (uint16_t i = 0; i < count; ++i)
+        buf[i] = read();
+}
+
+void OneWireRmt::write_bit(uint8_t v)
+{
+    const OwPulse tx = owWriteSlot(v & 1);
+    transact_(&tx, 1);
+}
+
+uint8_t OneWireRmt::read_bit()
+{
+    const OwPulse tx = owReadSlot();
+    OwPulse rx[MAX_PULSES];
+    if (transact_(&tx, 1, rx) == 0)
+        return 1;
+    return owDecodeBit(rx[0]) ? 1 : 0;
+}
+
+void OneWireRmt::select(const uint8_t rom[8])
+{
+    write(0x55); // Match ROM
+    for (uint8_t i = 0; i < 8; ++i)
+        write(rom[i]);
+}
+
+void OneWireRmt::skip()
+{
+    write(0xCC); // Skip ROM
+}
+
+void OneWireRmt::reset_search()
+{
+    lastDiscrepancy = 0;
+    lastDevice = false;
+    memset(romNo, 0, sizeof(romNo));
+}
+
+bool OneWireRmt::search(uint8_t *newAddr, bool searchMode)
+{
+    if (lastDevice)
+    {
+        reset_search();
+        return false;
+    }
+    if (!reset())
+    {
+        reset_search();
+        return false;
+    }
+
+    write(searchMode ? 0xF0 : 0xEC); // Search ROM / Alarm Search
+
+    uint8_t lastZero = 0;
+    for (uint8_t bitNo = 1; bitNo <= 64; ++bitNo)
+    {
+        const uint8_t byteNo = (bitNo - 1) / 8;
+        const uint8_t mask = uint8_t(1u << ((bitNo - 1) % 8));
+
+        const uint8_t idBit = read_bit();
+        const uint8_t cmpBit = read_bit();
+        if (idBit && cmpBit)
+        {
+            reset_search(); // nobody answered
+            return false;
+        }
+
+        bool dir;
+        if (idBit != cmpBit)
+        {
+            dir = idBit; // every remaining device agrees
+        }
+        else
+        {
+            // Discrepancy: replay the previous path up to the last fork, then take 1
+            if (bitNo < lastDiscrepancy)
+                dir = (romNo[byteNo] & mask) != 0;
+            else
+                dir = bitNo == lastDiscrepancy;
+            if (!dir)
+                lastZero = bitNo;
+        }
+
+        if (dir)
+            romNo[byteNo] |= mask;
+        else
+            romNo[byteNo] &= uint8_t(~mask);
+        write_bit(dir);
+    }
+
+    lastDiscrepancy = lastZero;
+    lastDevice = lastDiscrepancy == 0;
+    if (romNo[0] == 0 || owCrc8(romNo, 7) != romNo[7])
+    {
+        reset_search();
+        return false;
+    }
+    memcpy(newAddr, romNo, 8);
+    return true;
+}
+
+#endif // ONEWIRE_RMT
@@ -0,0 +1,66 @@
+#ifndef ONEWIRE_RMT_H
+#define ONEWIRE_RMT_H
+
+// Built only with -DONEWIRE_RMT=1 (see ds18b20_bus.h)
+#if ONEWIRE_RMT
+
+#include <Arduino.h>
+#include <driver/rmt.h>
+#include <freertos/ringbuf.h>
+#include "onewire_slots.h"
+
+// OneWire bus on the RMT peripheral: one TX and one RX channel share the
+// open-drain pin, the TX channel times every reset/write/read slot in hardware
+// and the RX channel captures the line (ours plus the slaves' pulls). The
+// calling task sleeps on the TX-done / RX ringbuffer instead of bit-banging
+// with interrupts masked, so the feeder ISR, ADS RDY and Wi-Fi keep running.
+//
+// Mirrors the subset of the OneWire library API Ds18b20Bus uses. Probes must be
+// VDD-powered (no strong pull-up for parasite power).
+class OneWireRmt
+{
+public:
+    // S3 legacy RMT driver: channels 0..3 transmit, 4..7 receive. The last pair
+    // stays clear of the core's own RMT users, which allocate from channel 0.
+    static constexpr rmt_channel_t DEFAULT_TX_CHANNEL = RMT_CHANNEL_3;
+    static constexpr rmt_channel_t DEFAULT_RX_CHANNEL = RMT_CHANNEL_7;
+
+    void begin(uint8_t pin,
+               rmt_channel_t txChannel = DEFAULT_TX_CHANNEL,
+               rmt_channel_t rxChannel = DEFAULT_RX_CHANNEL);
+
+    uint8_t reset(); // 1 if a presence pulse was seen
+    void select(const uint8_t rom[8]);
+    void skip();
+    void write(uint8_t v, uint8_t power = 0);
+    uint8_t read();
+    void read_bytes(uint8_t *buf, uint16_t count);
+    void write_bit(uint8_t v);
+    uint8_t read_bit();
+
+    void reset_search();
+    bool search(uint8_t *newAddr, bool searchMode = true);
+
+    static uint8_t crc8(const uint8_t *addr, uint8_t len) { return owCrc8(addr, len); }
+
+private:
+    static constexpr size_t MAX_PULSES = 8; // one byte per transaction
+    static constexpr uint32_t RX_TIMEOUT_MS = 5;
+
+    bool ready = false;
+    rmt_channel_t txCh = DEFAULT_TX_CHANNEL;
+    rmt_channel_t rxCh = DEFAULT_RX_CHANNEL;
+    RingbufHandle_t rxRing = nullptr;
+
+    // Search state (Maxim AN187)
+    uint8_t romNo[8] = {0};
+    uint8_t lastDiscrepancy = 0;
+    bool lastDevice = false;
+
+    // Transmit n pulses; with rx, capture the line and return the pulse count
+    // (0 on timeout). Without rx, returns n once the slots are on the wire.
+    size_t transact_(const OwPulse *tx, size_t n, OwPulse *rx = nullptr);
+};
+
+#endif // ONEWIRE_RMT
+#endif // ONEWIRE_RMT_H
@@ -0,0 +1,106 @@
+#ifndef ONEWIRE_SLOTS_H
+#define ONEWIRE_SLOTS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// 1-Wire standard-speed slots as low/high pulse pairs (µs), the shape a
+// hardware pulse generator (RMT) transmits and captures. Pure code: no
+// Arduino / IDF includes, so the encode/decode rules can be checked on a host.
+//
+// Every master-initiated slot is "pull low, then release". On the capture side
+// the same pair reads as "line low for lowUs, then high for highUs"; a slave
+// stretching the low phase (read 0, presence) shows up as a longer lowUs.
+// highUs == 0 marks the pulse the receiver closed on bus idle.
+
+struct OwPulse
+{
+    uint16_t lowUs;
+    uint16_t highUs;
+};
+
+// Timing (Maxim AN126, standard speed)
+constexpr uint16_t OW_RESET_LOW_US = 480;   // H
+constexpr uint16_t OW_RESET_HIGH_US = 480;  // I + J: presence window and recovery
+constexpr uint16_t OW_WRITE1_LOW_US = 6;    // A
+constexpr uint16_t OW_WRITE1_HIGH_US = 64;  // B
+constexpr uint16_t OW_WRITE0_LOW_US = 60;   // C
+constexpr uint16_t OW_WRITE0_HIGH_US = 10;  // D
+constexpr uint16_t OW_READ_SAMPLE_US = 15;  // slave holds a 0 at least this long
+constexpr uint16_t OW_PRESENCE_WAIT_MIN_US = 10;  // tPDH 15..60, with margin
+constexpr uint16_t OW_PRESENCE_WAIT_MAX_US = 75;
+constexpr uint16_t OW_PRESENCE_LOW_MIN_US = 50;   // tPDL 60..240, with margin
+constexpr uint16_t OW_PRESENCE_LOW_MAX_US = 300;
+
+// Receiver closes a capture after this much idle-high time: longer than any
+// in-slot high phase, shorter than the reset recovery
+constexpr uint16_t OW_RX_IDLE_US = 100;
+
+constexpr OwPulse owResetPulse() { return {OW_RESET_LOW_US, OW_RESET_HIGH_US}; }
+
+constexpr OwPulse owWriteSlot(bool bit)
+{
+    return bit ? OwPulse{OW_WRITE1_LOW_US, OW_WRITE1_HIGH_US}
+               : OwPulse{OW_WRITE0_LOW_US, OW_WRITE0_HIGH_US};
+}
+
+// A read slot is a write-1 slot; the slave answers 0 by holding the line low
+constexpr OwPulse owReadSlot() { return owWriteSlot(true); }
+
+constexpr bool owDecodeBit(const OwPulse &rx) { return rx.lowUs < OW_READ_SAMPLE_US; }
+
+// Byte → 8 write slots, LSB first. Returns the pulse count (8).
+inline size_t owEncodeByte(uint8_t value, OwPulse out[8])
+{
+    for (uint8_t i = 0; i < 8; ++i)
+        out[i] = owWriteSlot((value >> i) & 1);
+    return 8;
+}
+
+// 8 captured read slots → byte, LSB first. False on a short capture.
+inline bool owDecodeByte(const OwPulse *rx, size_t n, uint8_t &out)
+{
+    if (n < 8)
+        return false;
+    uint8_t v = 0;
+    for (uint8_t i = 0; i < 8; ++i)
+    {
+        if (owDecodeBit(rx[i]))
+            v |= uint8_t(1u << i);
+    }
+    out = v;
+    return true;
+}
+
+// Reset capture: our own 480 µs low, a short release, then a slave's
+// presence pulse. A bus held low, or nothing answering, is "no presence".
+inline bool owDecodePresence(const OwPulse *rx, size_t n)
+{
+    if (n < 2)
+        return false;
+    if (rx[0].lowUs < OW_RESET_LOW_US - OW_READ_SAMPLE_US || rx[0].lowUs > OW_RESET_LOW_US + OW_READ_SAMPLE_US)
+        return false; // shorted (stretched) or glitched reset
+    return rx[0].highUs >= OW_PRESENCE_WAIT_MIN_US && rx[0].highUs <= OW_PRESENCE_WAIT_MAX_US &&
+           rx[1].lowUs >= OW_PRESENCE_LOW_MIN_US && rx[1].lowUs <= OW_PRESENCE_LOW_MAX_US;
+}
+
+// Dallas/Maxim CRC-8 (x^8 + x^5 + x^4 + 1, reflected), as used for ROM and scratchpad
+inline uint8_t owCrc8(const uint8_t *data, size_t len)
+{
+    uint8_t crc = 0;
+    while (len--)
+    {
+        uint8_t in = *data++;
+        for (uint8_t i = 0; i < 8; ++i)
+        {
+            const uint8_t mix = (crc ^ in) & 0x01;
+            crc >>= 1;
+            if (mix)
+                crc ^= 0x8C;
+            in >>= 1;
+        }
+    }
+    return crc;
+}
+
+#endif // ONEWIRE_SLOTS_H
@@ -0,0 +1,79 @@
+#include "Temp_sensor/temp_estimator.h"
+#include <math.h>
+
+void TempEstimator::reset()
+{
+    initialised = false;
+    outlier = false;
+    rejectRun = 0;
+    accepted = 0;
+}
+
+void TempEstimator::init_(float measC)
+{
+    const float r = cfg.measSigmaC * cfg.measSigmaC;
+    t = measC;
+    s = 0.0f;
+    p00 = r;
+    p01 = 0.0f;
+    p11 = 1.0f; // (°C/min)²: slope unknown, a lamp ramp is ~1 °C/min
+    initialised = true;
+    rejectRun = 0;
+    accepted = 1;
+}
+
+bool TempEstimator::update(float z, float dt)
+{
+    if (!initialised)
+    {
+        init_(z);
+        outlier = false;
+        return true;
+    }
+    if (dt < 0.0f)
+        dt = 0.0f;
+
+    // Predict: x = F x, P = F P Fᵀ + Q (white-noise slope change)
+    t += s * dt;
+    const float q = cfg.slopeDrift * cfg.slopeDrift;
+    const float dt2 = dt * dt;
+    const float n00 = p00 + dt * (2.0f * p01 + dt * p11) + q * dt2 * dt / 3.0f;
+    const float n01 = p01 + dt * p11 + q * dt2 / 2.0f;
+    const float n11 = p11 + q * dt;
+    p00 = n00;
+    p01 = n01;
+    p11 = n11;
+
+    // Gate on the innovation
+    const float r = cfg.measSigmaC * cfg.measSigmaC;
+    const float y = z - t;
+    const float S = p00 + r;
+    float gate = cfg.gateSigma * sqrtf(S);
+    if (gate < cfg.gateFloorC)
+        gate = cfg.gateFloorC;
+
+    if (fabsf(y) > gate)
+    {
+        ++outliers;
+        outlier = true;
+        if (++rejectRun < cfg.maxRejects)
+            return false;
+        init_(z); // persistent: a real step, not a glitch
+        return false;
+    }
+
+    // Update
+    const float k0 = p00 / S;
+    const float k1 = p01 / S;
+    t += k0 * y;
+    s += k1 * y;
+    p11 -= k1 * p01;
+    p01 -= k0 * p01;
+    p00 -= k0 * p00;
+
+    outlier = false;
+    rejectRun = 0;
+    if (accepted < UINT16_MAX)
+        ++accepted;
+    return true;
+}
@@ -0,0 +1,64 @@
+#ifndef TEMP_ESTIMATOR_H
+#define TEMP_ESTIMATOR_H
+
+#include <stdint.h>
+
+// Per-probe temperature estimator: constant-velocity Kalman filter on
+// [temperature °C, slope °C/min]. O(1) state, host-buildable (no Arduino deps).
+//
+//  - Filtered temperature and slope from every accepted reading; time steps can
+//    be irregular (dt from the reading timestamps).
+//  - Outliers: innovation outside gateSigma·√S (and outside gateFloorC) is
+//    rejected without touching the state. maxRejects in a row means the
+//    temperature really stepped (probe moved / re-seated): re-initialise there.
+class TempEstimator
+{
+public:
+    struct Config
+    {
+        float measSigmaC = 0.12f;  // reading noise incl. quantisation (°C)
+        float slopeDrift = 0.2f;   // slope random walk, (°C/min) per √min
+        float gateSigma = 4.0f;    // innovation gate, σ units
+        float gateFloorC = 1.0f;   // never reject a reading within ±1 °C of prediction
+        uint8_t maxRejects = 3;    // consecutive rejects → accept as a step
+        uint8_t warmupReadings = 10; // slope is unreliable before this many accepts
+    };
+
+    TempEstimator() = default;
+    explicit TempEstimator(const Config &c) : cfg(c) {}
+
+    void setConfig(const Config &c) { cfg = c; }
+    const Config &config() const { return cfg; }
+
+    // Feed one reading (°C) taken dtMin after the previous one. Returns false
+    // when it was rejected as an outlier (state then only advances in time).
+    bool update(float measC, float dtMin);
+
+    // Forget everything (probe lost / replaced); next reading initialises
+    void reset();
+
+    bool isInitialised() const { return initialised; }
+    bool isWarm() const { return accepted >= cfg.warmupReadings; }
+    float tempC() const { return t; }
+    float slopeCPerMin() const { return s; }
+    bool lastWasOutlier() const { return outlier; }
+    uint32_t outlierCount() const { return outliers; }
+
+private:
+    Config cfg;
+
+    bool initialised = false;
+    bool outlier = false;
+    uint8_t rejectRun = 0;
+    uint16_t accepted = 0;
+    uint32_t outliers = 0;
+
+    // State and covariance
+    float t = 0.0f;
+    float s = 0.0f;
+    float p00 = 0.0f, p01 = 0.0f, p11 = 0.0f;
+
+    void init_(float measC);
+};
+
+#endif // TEMP_ESTIMATOR_H
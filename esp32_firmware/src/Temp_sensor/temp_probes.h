@@ -0,0 +1,57 @@
+#ifndef TEMP_PROBES_H
+#define TEMP_PROBES_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "topics.h"
+
+// ==============================
+// DS18B20 probe table (compile time)
+// ==============================
+//
+// All probes share one OneWire bus. Each row is a slot; the probe ROM bound to
+// a slot is cached in NVS ("ds_rom"), so boot does not search the bus. Slots
+// are filled in search order on first boot; "rescan" fills empty slots with
+// new probes, {"assign":"<name>","rom":"28..."} pins a probe to a slot.
+// Status/errors/rom topics are derived from the row's topic ("<topic>/status", ...).
+//
+// Resolution is per slot: 9 bit = 0.5 °C in 94 ms ... 12 bit = 0.0625 °C in 750 ms.
+// One broadcast convert serves every probe, so the cycle waits for the finest row.
+//
+// Every probe runs a Kalman estimator (temp_estimator.h); the main topic carries
+// the filtered value. maxRiseFPerMin > 0 arms a rate-of-rise alarm on the
+// filtered slope: it fires minutes before an absolute limit would.
+
+static constexpr uint8_t TEMP_BUS_PIN = 4; // 4.7 kΩ pull-up to 3V3
+
+struct TempProbeConfig
+{
+    const char *name;  // slot name for logs / assign command
+    const char *topic; // °F; base for derived topics
+    uint8_t resolutionBits; // 9..12
+    float maxRiseFPerMin;   // rate-of-rise alarm, °F/min (0 = off)
+};
+
+static constexpr TempProbeConfig TEMP_PROBES[] = {
+    {"basking", TOPIC_TEMP_BASKING, 10, 3.0f}, // above the normal lamp-on warm-up
+    {"water", TOPIC_TEMP_WATER, 10, 1.0f},     // stuck heater
+    {"cool", TOPIC_TEMP_COOL, 9, 0.0f},
+    {"ambient", TOPIC_TEMP_AMBIENT, 9, 0.0f},
+};
+static constexpr size_t TEMP_PROBE_COUNT = sizeof(TEMP_PROBES) / sizeof(TEMP_PROBES[0]);
+
+// Rows the OLED shows
+static constexpr size_t TEMP_PROBE_BASKING = 0;
+static constexpr size_t TEMP_PROBE_WATER = 1;
+
+static_assert(TEMP_PROBE_COUNT >= 2 && TEMP_PROBE_COUNT <= 8, "2..8 DS18B20 slots supported");
+
+constexpr bool tempResolutionsValid(size_t i = 0)
+{
+    return i >= TEMP_PROBE_COUNT ||
+           (TEMP_PROBES[i].resolutionBits >= 9 && TEMP_PROBES[i].resolutionBits <= 12 &&
+            TEMP_PROBES[i].maxRiseFPerMin >= 0.0f && tempResolutionsValid(i + 1));
+}
+static_assert(tempResolutionsValid(), "DS18B20 resolution must be 9..12 bits, rise limit >= 0");
+
+#endif // TEMP_PROBES_H
@@ -1,46 +1,317 @@
 #include "temp_sensor_manager.h"
-#include <PubSubClient.h>
+#include "mqtt/telemetry_publisher.h"
+#include <Preferences.h>
+#include <math.h>
 #include "topics.h"
 
-void TempSensorManager::begin(PubSubClient &mqttClient,
-                              uint8_t baskingPin,
-                              uint8_t waterPin,
+// Alarm clears once the slope falls below this share of the limit
+static constexpr float RISE_CLEAR_FRACTION = 0.5f;
+
+// Publish deadbands (heartbeat refreshes the rest)
+static constexpr float TEMP_DEADBAND_F = 0.2f;
+static constexpr float SLOPE_DEADBAND_F_PER_MIN = 0.1f;
+
+void TempSensorManager::begin(TelemetryPublisher &telemetry,
+                              uint8_t busPin,
                               unsigned long readIntervalMs,
                               unsigned long publishIntervalMs)
 {
-    mqtt = &mqttClient;
-    basking.begin(baskingPin);
-    water.begin(waterPin);
+    mqtt = &telemetry;
     readIntMs = readIntervalMs;
     pubIntervalMs = publishIntervalMs;
+
+    for (size_t i = 0; i < TEMP_PROBE_COUNT; ++i)
+    {
+        SlotState &s = slots[i];
+        const char *base = TEMP_PROBES[i].topic;
+        snprintf(s.topicStatus, TOPIC_LEN, "%s/status", base);
+        snprintf(s.topicErrors, TOPIC_LEN, "%s/errors", base);
+        snprintf(s.topicRom, TOPIC_LEN, "%s/rom", base);
+        snprintf(s.topicSlope, TOPIC_LEN, "%s/slope", base);
+        snprintf(s.topicAlarm, TOPIC_LEN, "%s/alarm", base);
+
+        // Reading noise: ~0.1 °C sensor noise plus the resolution's quantisation
+        TempEstimator::Config ec;
+        const float q = 0.0625f * float(1u << (12 - TEMP_PROBES[i].resolutionBits));
+        ec.measSigmaC = sqrtf(0.01f + q * q / 12.0f);
+        s.est.setConfig(ec);
+        s.alarmPublished = TEMP_PROBES[i].maxRiseFPerMin <= 0.0f; // armed rows start at "OK"
+    }
+
+    bus.begin(busPin);
+    for (size_t i = 0; i < TEMP_PROBE_COUNT; ++i)
+        bus.setResolution(uint8_t(i), TEMP_PROBES[i].resolutionBits);
+
+    // Warm boot: ROMs from NVS, no bus search. First boot: search once and cache.
+    loadRoms_();
+    bool any = false;
+    for (size_t i = 0; i < TEMP_PROBE_COUNT; ++i)
+        any |= bus.probe(i).bound;
+    if (!any)
+        rescan_();
+
+    // No acquisition task yet: the bus can be read directly this once
+    ProbeSnapshot boot[TEMP_PROBE_COUNT];
+    snapshot_(boot);
+    for (size_t i = 0; i < TEMP_PROBE_COUNT; ++i)
+        slots[i].probe = boot[i];
+    romsDirty = false; // romsChanged already covers the first publish
 }
 
 void TempSensorManager::updateReadings()
 {
-    unsigned long now = millis();
+    if (!externalAcquire)
+        acquire();
 
-    // Kick off a new conversion every readIntervalMs
-    if (!waitingForRead && (now - lastReadTick >= readIntMs))
+    TempSample t;
+    while (readings.pop(t))
     {
-        basking.requestTemperature();
-        water.requestTemperature();
-        lastReadTick = now; // mark start of conversion
-        waitingForRead = true;
+        const uint32_t dtMs = lastSampleMs ? t.tMs - lastSampleMs : 0;
+        for (size_t i = 0; i < TEMP_PROBE_COUNT; ++i)
+        {
+            const bool present = t.presentMask & (1u << i);
+            if (present)
+                slots[i].raw = t.raw[i];
+            if (present != slots[i].present || lastSampleMs == 0)
+                slots[i].statusPublished = false;
+            slots[i].present = present;
+            slots[i].probe = t.probe[i];
+            filter_(i, present, t.raw[i], dtMs);
+        }
+        if (t.romsChanged)
+            romsChanged = true;
+        lastSampleMs = t.tMs;
+        cycleMs = t.cycleMs;
+    }
+}
+
+void TempSensorManager::filter_(size_t i, bool present, int16_t raw, uint32_t dtMs)
+{
+    SlotState &s = slots[i];
+    if (!present)
+    {
+        // Gap in the data: restart the filter, an alarm can no longer be judged
+        s.est.reset();
+        if (s.riseAlarm)
+        {
+            s.riseAlarm = false;
+            publishAlarm_(i);
+        }
         return;
     }
 
-    // After the sensor's internal conversion time, capture values
-    if (waitingForRead && (now - lastReadTick >= DS18B20Sensor::CONVERSION_DELAY_MS))
+    s.est.update(Ds18b20Bus::toC(raw), dtMs / 60000.0f);
+
+    const float limit = TEMP_PROBES[i].maxRiseFPerMin;
+    if (limit <= 0.0f || !s.est.isWarm())
+        return;
+    const float slopeF = s.est.slopeCPerMin() * 1.8f;
+    const bool alarm = s.riseAlarm ? slopeF >= limit * RISE_CLEAR_FRACTION : slopeF >= limit;
+    if (alarm != s.riseAlarm)
     {
-        bool ok1 = basking.readTemperature();
-        bool ok2 = water.readTemperature();
-        if (ok1 && ok2)
+        s.riseAlarm = alarm;
+        Serial.printf("[Temp] %s rise %s: %.2f F/min (limit %.2f)\n", TEMP_PROBES[i].name,
+                      alarm ? "ALARM" : "cleared", slopeF, limit);
+        publishAlarm_(i); // now, not on the publish cadence
+    }
+}
+
+void TempSensorManager::publishAlarm_(size_t i)
+{
+    SlotState &s = slots[i];
+    s.alarmPublished = mqtt && mqtt->publish(s.topicAlarm, s.riseAlarm ? "RISE" : "OK", true);
+}
+
+float TempSensorManager::getTempC(size_t slot) const
+{
+    if (slot >= TEMP_PROBE_COUNT)
+        return 0.0f;
+    const TempEstimator &e = slots[slot].est;
+    return e.isInitialised() ? e.tempC() : Ds18b20Bus::toC(slots[slot].raw);
+}
+
+float TempSensorManager::getSlopeFPerMin(size_t slot) const
+{
+    if (slot >= TEMP_PROBE_COUNT || !slots[slot].est.isWarm())
+        return 0.0f;
+    return slots[slot].est.slopeCPerMin() * 1.8f;
+}
+
+void TempSensorManager::acquire()
+{
+    const unsigned long now = millis();
+
+    switch (phase)
+    {
+    case Phase::Idle:
+        // Resolution writes ride the idle gap, one probe per call
+        if (bus.configureNext())
+            return;
+        if (now - lastReadTick < readIntMs)
+            return;
+        lastReadTick = now; // keeps the overall cadence consistent
+
+        // Bus management only between cycles, never mid-read
+        if (rescanRequested)
+        {
+            rescanRequested = false;
+            rescan_();
+        }
+        {
+            AssignRequest a;
+            while (assigns.pop(a))
+                applyAssign_(a);
+        }
+
+        // One broadcast conversion for every probe on the bus
+        if (bus.startConversion())
+        {
+            phase = Phase::Converting;
+        }
+        else
+        {
+            readSlot = 0; // nobody answered: the reads count the misses
+            phase = Phase::Reading;
+        }
+        return;
+
+    case Phase::Converting:
+        // Done when the slowest resolution's window ends, or earlier if the
+        // probes already release the bus (one 70 µs read slot per call)
+        if (now - lastReadTick < bus.conversionWindowMs() && !bus.conversionDone())
+            return;
+        readSlot = 0;
+        phase = Phase::Reading;
+        return;
+
+    case Phase::Reading:
+    default:
+        if (readSlot < TEMP_PROBE_COUNT)
+        {
+            if (bus.probe(readSlot).bound)
+                bus.readProbe(readSlot);
+            ++readSlot;
+            return;
+        }
+
+        pending.tMs = now;
+        pending.cycleMs = now - lastReadTick;
+        pending.presentMask = 0;
+        for (size_t i = 0; i < TEMP_PROBE_COUNT; ++i)
         {
-            waitingForRead = false;
-            // lastReadTick remains the time we triggered the conversion,
-            // which keeps the overall cadence consistent.
+            const Ds18b20Bus::Probe &p = bus.probe(i);
+            pending.raw[i] = p.raw;
+            if (p.present)
+                pending.presentMask |= uint8_t(1u << i);
         }
+        snapshot_(pending.probe);
+        pending.romsChanged = romsDirty;
+        if (readings.push(pending))
+            romsDirty = false; // else the next cycle carries it
+        phase = Phase::Idle;
+        return;
+    }
+}
+
+bool TempSensorManager::requestAssign(const char *slotName, const char *romHex)
+{
+    if (!slotName)
+        return false;
+    for (size_t i = 0; i < TEMP_PROBE_COUNT; ++i)
+    {
+        if (strcasecmp(slotName, TEMP_PROBES[i].name) != 0)
+            continue;
+        AssignRequest a;
+        a.slot = uint8_t(i);
+        if (!Ds18b20Bus::hexToRom(romHex, a.rom))
+            return false;
+        return assigns.push(a); // copied whole; the producer never sees a half-written ROM
+    }
+    return false;
+}
+
+void TempSensorManager::snapshot_(ProbeSnapshot (&out)[TEMP_PROBE_COUNT]) const
+{
+    for (size_t i = 0; i < TEMP_PROBE_COUNT; ++i)
+    {
+        const Ds18b20Bus::Probe &p = bus.probe(uint8_t(i));
+        ProbeSnapshot &o = out[i];
+        memcpy(o.rom, p.rom, sizeof(o.rom));
+        o.bound = p.bound;
+        o.reads = p.reads;
+        o.crcErrors = p.crcErrors;
+        o.porErrors = p.porErrors;
+        o.disconnects = p.disconnects;
+    }
+}
+
+void TempSensorManager::loadRoms_()
+{
+    Preferences prefs;
+    prefs.begin("ds_rom", true); // RO
+    for (size_t i = 0; i < TEMP_PROBE_COUNT; ++i)
+    {
+        char key[4];
+        snprintf(key, sizeof(key), "r%u", (unsigned)i);
+        uint8_t rom[8];
+        if (prefs.getBytesLength(key) == sizeof(rom) && prefs.getBytes(key, rom, sizeof(rom)) == sizeof(rom) &&
+            Ds18b20Bus::romValid(rom))
+            bus.bind(uint8_t(i), rom);
+    }
+    prefs.end();
+}
+
+void TempSensorManager::saveRom_(uint8_t slot)
+{
+    Preferences prefs;
+    if (!prefs.begin("ds_rom", false)) // RW
+        return;
+    char key[4];
+    snprintf(key, sizeof(key), "r%u", (unsigned)slot);
+    const Ds18b20Bus::Probe &p = bus.probe(slot);
+    if (p.bound)
+        prefs.putBytes(key, p.rom, sizeof(p.rom));
+    else
+        prefs.remove(key);
+    prefs.end();
+}
+
+void TempSensorManager::rescan_()
+{
+    // Known probes keep their slot; new ones fill empty slots in search order
+    uint8_t found[Ds18b20Bus::MAX_PROBES][8];
+    const uint8_t n = bus.search(found, Ds18b20Bus::MAX_PROBES);
+    for (uint8_t k = 0; k < n; ++k)
+    {
+        if (bus.findSlot(found[k]) >= 0)
+            continue;
+        for (size_t i = 0; i < TEMP_PROBE_COUNT; ++i)
+        {
+            if (bus.probe(i).bound)
+                continue;
+            bus.bind(uint8_t(i), found[k]);
+            saveRom_(uint8_t(i));
+            romsDirty = true;
+            break;
+        }
+    }
+    Serial.printf("[Temp] bus search: %u probe(s)\n", n);
+}
+
+void TempSensorManager::applyAssign_(const AssignRequest &a)
+{
+    // A ROM lives in one slot only
+    const int old = bus.findSlot(a.rom);
+    if (old == a.slot)
+        return;
+    if (old >= 0)
+    {
+        bus.unbind(uint8_t(old));
+        saveRom_(uint8_t(old));
     }
+    bus.bind(a.slot, a.rom);
+    saveRom_(a.slot);
+    romsDirty = true;
 }
 
 void TempSensorManager::publishIfDue()
@@ -56,12 +327,74 @@ void TempSensorManager::publishIfDue()
 void TempSensorManager::publishNow()
 {
     // Publish whatever the latest cached temps are (even if they’re from <publishIntervalMs ago)
-    mqtt->publish(TOPIC_TEMP_BASKING, String(basking.getTemperatureF()).c_str(), true);
-    mqtt->publish(TOPIC_TEMP_WATER, String(water.getTemperatureF()).c_str(), true);
+    for (size_t i = 0; i < TEMP_PROBE_COUNT; ++i)
+    {
+        if (slots[i].present)
+        {
+            // 9 bit is 0.9 °F per step, so one decimal keeps every resolution
+            mqtt->publishValue(TEMP_PROBES[i].topic, getTempFf(i), 1, TEMP_DEADBAND_F);
+            if (slots[i].est.isWarm())
+                mqtt->publishValue(slots[i].topicSlope, getSlopeFPerMin(i), 2, SLOPE_DEADBAND_F_PER_MIN);
+        }
+        if (!slots[i].alarmPublished)
+            publishAlarm_(i); // retry after a failed immediate send / first connect
+    }
+    publishHealth_();
+    if (romsChanged)
+        publishRoms_();
+}
+
+void TempSensorManager::publishHealth_()
+{
+    for (size_t i = 0; i < TEMP_PROBE_COUNT; ++i)
+    {
+        SlotState &s = slots[i];
+        const ProbeSnapshot &p = s.probe;
 
-    // If you want to only publish when changed, track last published values here
-    // and early-return when unchanged.
+        if (!s.statusPublished)
+            s.statusPublished = mqtt->publish(s.topicStatus, !p.bound ? "UNASSIGNED" : (s.present ? "OK" : "DISCONNECTED"), true);
+
+        // Counters only when one of them moved
+        const uint32_t outliers = s.est.outlierCount();
+        const uint32_t sum = p.crcErrors + p.porErrors + p.disconnects + outliers;
+        if (sum == s.errorsPublished)
+            continue;
+        char buf[112];
+        snprintf(buf, sizeof(buf), "{\"reads\":%lu,\"crc\":%lu,\"por\":%lu,\"disconnects\":%lu,\"outliers\":%lu}",
+                 (unsigned long)p.reads, (unsigned long)p.crcErrors,
+                 (unsigned long)p.porErrors, (unsigned long)p.disconnects, (unsigned long)outliers);
+        if (mqtt->publish(s.topicErrors, buf, true))
+            s.errorsPublished = sum; // else retried next publish
+    }
 }
 
-int TempSensorManager::getBaskingTemp() const { return basking.getTemperatureF(); }
-int TempSensorManager::getWaterTemp() const { return water.getTemperatureF(); }
+void TempSensorManager::publishRoms_()
+{
+    romsChanged = false;
+    bool sent = true;
+    for (size_t i = 0; i < TEMP_PROBE_COUNT; ++i)
+    {
+        const ProbeSnapshot &p = slots[i].probe;
+        char hex[17] = "";
+        if (p.bound)
+            Ds18b20Bus::romToHex(p.rom, hex);
+        sent &= mqtt->publish(slots[i].topicRom, hex, true);
+        slots[i].statusPublished = false; // UNASSIGNED ↔ bound
+    }
+    if (!sent)
+        romsChanged = true; // offline / outbox full: all of them again next publish
+}
+
+void TempSensorManager::invalidate()
+{
+    for (size_t i = 0; i < TEMP_PROBE_COUNT; ++i)
+    {
+        SlotState &s = slots[i];
+        if (lastSampleMs != 0)
+            s.statusPublished = false; // before the first bus cycle it is still pending anyway
+        s.errorsPublished = UINT32_MAX;
+        if (TEMP_PROBES[i].maxRiseFPerMin > 0.0f)
+            s.alarmPublished = false;
+    }
+    romsChanged = true;
+}
@@ -1,54 +1,162 @@
 #ifndef TEMP_SENSOR_MANAGER_H
 #define TEMP_SENSOR_MANAGER_H
 
-class PubSubClient;
-#include "ds18b20_sensor.h"
+class TelemetryPublisher;
+#include "ds18b20_bus.h"
+#include "temp_probes.h"
+#include "temp_estimator.h"
+#include "sampling/spsc_ring.h"
 
+// Every DS18B20 in TEMP_PROBES on one OneWire bus (temp_probes.h).
+// acquire() is the producer (bus traffic, may run on SamplingTask's OneWire task);
+// updateReadings()/publish*() are the consumer side in loop().
 class TempSensorManager
 {
 public:
-    // Provide pins for each DS18B20
-    void begin(PubSubClient &mqttClient,
-               uint8_t baskingPin,
-               uint8_t waterPin,
+    void begin(TelemetryPublisher &telemetry,
+               uint8_t busPin,
                unsigned long readIntervalMs,
                unsigned long publishIntervalMs);
 
-    // 1) Refresh readings on your chosen cadence (non-blocking)
+    // 1) Refresh readings on your chosen cadence (non-blocking).
+    //    Drains finished readings from the acquisition ring; also runs acquire()
+    //    itself unless the OneWire task owns it.
     void updateReadings();
 
+    // Producer side: broadcast convert, then one addressed read per call (~10 ms
+    // of bus traffic on the bit-bang backend). Called from SamplingTask's
+    // OneWire task when one is attached, below the ADS1115 RDY path.
+    void acquire();
+    void setExternalAcquisition(bool en) { externalAcquire = en; }
+
     // 2) Publish latest cached readings if publish interval elapsed
     void publishIfDue();
 
     // 3) Publish immediately (e.g., after MQTT reconnect)
     void publishNow();
+    // Broker may have lost retained state (reconnect): status, errors, ROMs and
+    // armed alarms go out again on the next publish
+    void invalidate();
+
+    // Probe management (applied by acquire() on the next cycle; ROMs persist in NVS).
+    // requestAssign() is false for an unknown slot, a bad ROM or a full queue.
+    void requestRescan() { rescanRequested = true; }
+    bool requestAssign(const char *slotName, const char *romHex);
+
+    // Accessors for OLED/UI. Readings are kept as raw 1/16 °C plus the filter
+    // state in °C; units happen here. Temperatures are filtered once available.
+    int getBaskingTemp() const { return getTempF(TEMP_PROBE_BASKING); }
+    int getWaterTemp() const { return getTempF(TEMP_PROBE_WATER); }
+    int getTempF(size_t slot) const { return int(lroundf(getTempFf(slot))); }
+    float getTempFf(size_t slot) const { return getTempC(slot) * 1.8f + 32.0f; }
+    float getTempC(size_t slot) const;
+    int16_t getRaw(size_t slot) const { return slot < TEMP_PROBE_COUNT ? slots[slot].raw : 0; }
+    bool isPresent(size_t slot) const { return slot < TEMP_PROBE_COUNT && slots[slot].present; }
+    float getSlopeFPerMin(size_t slot) const;
+    bool isOutlier(size_t slot) const { return slot < TEMP_PROBE_COUNT && slots[slot].est.lastWasOutlier(); }
+    bool isRiseAlarm(size_t slot) const { return slot < TEMP_PROBE_COUNT && slots[slot].riseAlarm; }
 
-    // Accessors for OLED/UI
-    int getBaskingTemp() const;
-    int getWaterTemp() const;
+    // Last bus cycle, convert start → last read (ms)
+    uint32_t getCycleMs() const { return cycleMs; }
 
 private:
-    DS18B20Sensor basking{"basking"};
-    DS18B20Sensor water{"water"};
+    static constexpr size_t TOPIC_LEN = 48;
+
+    // Binding and counters of one slot as the producer last saw them; loop()
+    // publishes from this copy, never from the live Ds18b20Bus
+    struct ProbeSnapshot
+    {
+        uint8_t rom[8] = {0};
+        bool bound = false;
+        uint32_t reads = 0;
+        uint32_t crcErrors = 0;
+        uint32_t porErrors = 0;
+        uint32_t disconnects = 0;
+    };
+
+    // One finished bus cycle, handed from the producer to loop()
+    struct TempSample
+    {
+        uint32_t tMs;
+        uint32_t cycleMs;
+        int16_t raw[TEMP_PROBE_COUNT]; // 1/16 °C
+        uint8_t presentMask;
+        bool romsChanged; // a rescan / assign rebound a slot this cycle
+        ProbeSnapshot probe[TEMP_PROBE_COUNT];
+    };
+
+    // loop() → producer
+    struct AssignRequest
+    {
+        uint8_t slot;
+        uint8_t rom[8];
+    };
+
+    // Consumer-side view of each slot
+    struct SlotState
+    {
+        int16_t raw = 0; // 1/16 °C
+        bool present = false;
+        TempEstimator est;
+        ProbeSnapshot probe;
+        bool riseAlarm = false;
+        bool alarmPublished = true; // only transitions are sent (retained)
+        bool statusPublished = true; // first bus cycle decides OK / DISCONNECTED
+        uint32_t errorsPublished = UINT32_MAX; // sum of counters last sent
+        char topicStatus[TOPIC_LEN] = {0};
+        char topicErrors[TOPIC_LEN] = {0};
+        char topicRom[TOPIC_LEN] = {0};
+        char topicSlope[TOPIC_LEN] = {0};
+        char topicAlarm[TOPIC_LEN] = {0};
+    };
+
+    // Producer phases
+    enum class Phase : uint8_t
+    {
+        Idle,
+        Converting,
+        Reading
+    };
+
+    Ds18b20Bus bus;
+    SlotState slots[TEMP_PROBE_COUNT];
+
+    SpscRing<TempSample, 8> readings;
+    bool externalAcquire = false;
+    uint32_t lastSampleMs = 0;
+    uint32_t cycleMs = 0;
 
     // Cross-services (wired in begin)
-    PubSubClient *mqtt = nullptr;
+    TelemetryPublisher *mqtt = nullptr;
 
     // Timing
-
     unsigned long readIntMs = 3000;
     unsigned long pubIntervalMs = 5000;
 
-    // Reading cadence
-    unsigned long lastReadTick = 0;
-    bool waitingForRead = false;
+    // Reading cadence (producer)
+    Phase phase = Phase::Idle;
+    unsigned long lastReadTick = 0; // convert start
+    uint8_t readSlot = 0;
+    TempSample pending{};
+
+    // Probe management requests (loop → producer); ROM changes come back in TempSample
+    volatile bool rescanRequested = false;
+    SpscRing<AssignRequest, 4> assigns;
+    bool romsDirty = false;   // producer: not yet handed over in a TempSample
+    bool romsChanged = true;  // consumer: publish once at boot
 
     // Publish cadence
     unsigned long lastPublishTick = 0;
 
-    // Optional: cache last published values if you want "publish on change" later
-    // int lastPubBasking = INT_MIN;
-    // int lastPubWater   = INT_MIN;
+    void loadRoms_();
+    void saveRom_(uint8_t slot);
+    void rescan_();
+    void applyAssign_(const AssignRequest &a);
+    void snapshot_(ProbeSnapshot (&out)[TEMP_PROBE_COUNT]) const;
+    void publishRoms_();
+    void publishHealth_();
+    void filter_(size_t slot, bool present, int16_t raw, uint32_t dtMs);
+    void publishAlarm_(size_t slot);
 };
 
 #endif // TEMP_SENSOR_MANAGER_H
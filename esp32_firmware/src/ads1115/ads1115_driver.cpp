@@ -1,6 +1,6 @@
 #include "ads1115/ads1115_driver.h"
 
-Ads1115Driver::Ads1115Driver(uint8_t i2cAddr): addr(i2cAddr), currentGain(GAIN_TWOTHIRDS), currentDataRate(RATE_ADS1115_128SPS){}
+Ads1115Driver::Ads1115Driver(uint8_t i2cAddr): addr(i2cAddr), currentGain(GAIN_TWOTHIRDS), currentDataRate(RATE_ADS1115_128SPS), pairGain{GAIN_TWOTHIRDS, GAIN_TWOTHIRDS}{}
 
 bool Ads1115Driver::begin(adsGain_t gain, uint16_t dataRate)
 {
@@ -8,6 +8,7 @@ bool Ads1115Driver::begin(adsGain_t gain, uint16_t dataRate)
     if (!ads.begin(addr))
         return false;
     setGain(gain);
+    pairGain[0] = pairGain[1] = gain;
     setDataRate(dataRate);
     return true;
 }
@@ -18,6 +19,20 @@ void Ads1115Driver::setGain(adsGain_t gain)
     ads.setGain(gain);
 }
 
+void Ads1115Driver::setPairGain(uint8_t pair, adsGain_t gain)
+{
+    if (pair <= 1)
+        pairGain[pair] = gain;
+}
+
+void Ads1115Driver::applyPairGain_(uint8_t pair)
+{
+    // Adafruit only caches the PGA bits; they reach the chip with the next
+    // config write (the mux switch / single-shot start that follows)
+    if (pairGain[pair] != currentGain)
+        setGain(pairGain[pair]);
+}
+
 void Ads1115Driver::setDataRate(uint16_t dataRate)
 {
     currentDataRate = dataRate;
@@ -26,6 +41,36 @@ void Ads1115Driver::setDataRate(uint16_t dataRate)
 
 int16_t Ads1115Driver::readDiffPair(uint8_t pair) const
 {
+    if (continuous)
+    {
+        // A single-shot read would reprogram the chip out of continuous mode,
+        // so wait for the stream to deliver a sample for this pair instead.
+        Ads1115Driver &self = const_cast<Ads1115Driver &>(*this);
+        const unsigned long start = millis();
+        AdsSample s;
+        while (self.drain(pair, &s, 1) == 0)
+        {
+            if (millis() - start >= CONTINUOUS_READ_TIMEOUT_MS)
+                return 0;
+            if (serviceTask)
+            {
+                delay(1); // the sampling task is the only producer
+            }
+            else
+            {
+                self.service();
+                delayMicroseconds(adsConversionUs(currentDataRate) / 4);
+            }
+        }
+        return s.raw;
+    }
+
+    if (comparator)
+        return const_cast<Ads1115Driver &>(*this).readWhileComparing_(pair);
+
+    if (pair <= 1)
+        const_cast<Ads1115Driver &>(*this).applyPairGain_(pair);
+
     // Adafruit API read methods are non-const; const_cast is OK here
     switch (pair)
     {
@@ -38,24 +83,258 @@ int16_t Ads1115Driver::readDiffPair(uint8_t pair) const
     }
 }
 
-float Ads1115Driver::lsbVolts() const
+bool Ads1115Driver::beginContinuous(uint8_t pin, uint16_t perPair, uint8_t mask)
 {
-    // Full-scale / 32768 (signed 16-bit)
-    switch (currentGain)
+    mask &= 0x03;
+    if (pin == NO_ALERT_PIN || mask == 0)
+        return false;
+
+    stopContinuous();
+    stopComparator(); // same ALERT pin, different meaning
+
+    alertPin = pin;
+    samplesPerPair = perPair ? perPair : 1;
+    pairMask = mask;
+    for (RawRing &r : rings)
     {
-    case GAIN_TWOTHIRDS:
-        return 6.144f / 32768.0f;
-    case GAIN_ONE:
-        return 4.096f / 32768.0f;
-    case GAIN_TWO:
-        return 2.048f / 32768.0f;
-    case GAIN_FOUR:
-        return 1.024f / 32768.0f;
-    case GAIN_EIGHT:
-        return 0.512f / 32768.0f; // ≈ 15.625 µV/LSB
-    case GAIN_SIXTEEN:
-        return 0.256f / 32768.0f;
-    default:
-        return 2.048f / 32768.0f;
+        r.q.clear();
+        r.gapPending = true;
+    }
+    readyEdges = 0;
+    servicedEdges = 0;
+
+    // ALERT/RDY is open-drain; it pulses low for ~8 µs at the end of each conversion
+    pinMode(alertPin, INPUT_PULLUP);
+    attachInterruptArg(digitalPinToInterrupt(alertPin), &Ads1115Driver::onReady_, this, FALLING);
+
+    continuous = true;
+    startPair_((pairMask & 0x01) ? 0 : 1);
+    return true;
+}
+
+void Ads1115Driver::stopContinuous()
+{
+    if (!continuous)
+        return;
+    detachInterrupt(digitalPinToInterrupt(alertPin));
+    continuous = false;
+
+    // Leave the chip idle in single-shot mode (next readDiffPair() reprograms it)
+    ads.startADCReading(muxFor_(activePair), /*continuous=*/false);
+}
+
+void Ads1115Driver::service()
+{
+    if (!continuous)
+        return;
+
+    const uint32_t edges = readyEdges;
+    if (edges == servicedEdges)
+        return; // nothing converted since last read → no bus traffic
+
+    // The conversion register only holds the latest result
+    if (edges - servicedEdges > 1)
+    {
+        overrunCount += edges - servicedEdges - 1;
+        rings[activePair].gapPending = true;
+    }
+    servicedEdges = edges;
+
+    const int16_t raw = ads.getLastConversionResults();
+    const uint32_t tUs = micros();
+
+    if (discardNext)
+    {
+        discardNext = false; // first result after a mux change may straddle both inputs
+        return;
+    }
+
+    push_(activePair, raw, tUs);
+
+    // Rotate only when both pairs are in use; a single pair streams uninterrupted
+    if (++pairCount >= samplesPerPair && pairMask == 0x03)
+        startPair_(activePair ^ 1);
+}
+
+size_t Ads1115Driver::drain(uint8_t pair, AdsSample *out, size_t maxCount)
+{
+    if (pair > 1 || !out)
+        return 0;
+    return rings[pair].q.drain(out, maxCount);
+}
+
+size_t Ads1115Driver::available(uint8_t pair) const
+{
+    return pair > 1 ? 0 : rings[pair].q.size();
+}
+
+void Ads1115Driver::startPair_(uint8_t pair)
+{
+    activePair = pair;
+    pairCount = 0;
+    discardNext = true;
+    rings[pair].gapPending = true;
+    applyPairGain_(pair);
+    // Re-arms RDY mode (hi/lo threshold MSBs) along with the new mux
+    ads.startADCReading(muxFor_(pair), /*continuous=*/true);
+}
+
+void Ads1115Driver::push_(uint8_t pair, int16_t raw, uint32_t tUs)
+{
+    RawRing &r = rings[pair];
+    const AdsSample sample{tUs, raw, uint8_t(r.gapPending ? SAMPLE_GAP : 0)};
+    if (!r.q.push(sample))
+    {
+        ++overrunCount; // consumer fell behind; keep what is already queued
+        r.gapPending = true;
+        return;
     }
-}
\ No newline at end of file
+    r.gapPending = false;
+}
+
+uint16_t Ads1115Driver::muxFor_(uint8_t pair)
+{
+    return pair == 0 ? ADS1X15_REG_CONFIG_MUX_DIFF_0_1 : ADS1X15_REG_CONFIG_MUX_DIFF_2_3;
+}
+
+bool Ads1115Driver::beginComparator(uint8_t pin, uint8_t pair, int16_t lo, int16_t hi,
+                                    uint32_t faultTimeoutMs)
+{
+    if (pin == NO_ALERT_PIN || pair > 1 || faultTimeoutMs == 0)
+        return false;
+
+    stopContinuous();
+    stopComparator();
+
+    if (!faultTimer)
+        faultTimer = xTimerCreate("adsFault", pdMS_TO_TICKS(faultTimeoutMs), pdFALSE, this,
+                                  &Ads1115Driver::onFaultTimer_);
+    else
+        xTimerChangePeriod(faultTimer, pdMS_TO_TICKS(faultTimeoutMs), 0);
+    if (!faultTimer)
+        return false;
+
+    alertPin = pin;
+    cmpPair = pair;
+    cmpLo = lo;
+    cmpHi = hi;
+    cmpFault = false;
+
+    pinMode(alertPin, INPUT_PULLUP);
+    attachInterruptArg(digitalPinToInterrupt(alertPin), &Ads1115Driver::onWindow_, this, FALLING);
+
+    comparator = true;
+    armComparator_();
+    return true;
+}
+
+void Ads1115Driver::setComparatorWindow(uint8_t pair, int16_t lo, int16_t hi)
+{
+    if (!comparator || pair > 1)
+        return;
+    cmpPair = pair;
+    cmpLo = lo;
+    cmpHi = hi;
+    armComparator_();
+}
+
+void Ads1115Driver::stopComparator()
+{
+    if (!comparator)
+        return;
+    xTimerStop(faultTimer, 0);
+    detachInterrupt(digitalPinToInterrupt(alertPin));
+    comparator = false;
+    cmpFault = false;
+
+    // Back to idle single-shot; startADCReading also restores the RDY thresholds
+    ads.startADCReading(muxFor_(cmpPair), /*continuous=*/false);
+}
+
+bool Ads1115Driver::takeComparatorFault()
+{
+    if (!cmpFault)
+        return false;
+    cmpFault = false;
+    return true;
+}
+
+void Ads1115Driver::armComparator_()
+{
+    applyPairGain_(cmpPair);
+
+    // Thresholds first so the first conversion is already judged by the new window
+    writeRegister_(ADS1X15_REG_POINTER_HITHRESH, uint16_t(cmpHi));
+    writeRegister_(ADS1X15_REG_POINTER_LOWTHRESH, uint16_t(cmpLo));
+
+    const uint16_t config = ADS1X15_REG_CONFIG_CQUE_1CONV |   // assert after one conversion outside
+                            ADS1X15_REG_CONFIG_CLAT_NONLAT |  // release when back inside → one edge per excursion
+                            ADS1X15_REG_CONFIG_CPOL_ACTVLOW |
+                            ADS1X15_REG_CONFIG_CMODE_WINDOW |
+                            ADS1X15_REG_CONFIG_MODE_CONTIN |
+                            uint16_t(currentGain) | currentDataRate | muxFor_(cmpPair);
+    writeRegister_(ADS1X15_REG_POINTER_CONFIG, config);
+
+    // Fresh deadline from now; a missing load then faults within the timeout
+    cmpFault = false;
+    xTimerReset(faultTimer, 0);
+}
+
+int16_t Ads1115Driver::readWhileComparing_(uint8_t pair)
+{
+    if (pair == cmpPair)
+    {
+        // Free-running: wait one conversion so consecutive reads are distinct
+        delayMicroseconds(adsConversionUs(currentDataRate));
+        return ads.getLastConversionResults();
+    }
+
+    // Other pair: single-shot (rewrites config + thresholds), then re-arm the window
+    xTimerStop(faultTimer, 0);
+    applyPairGain_(pair);
+    const int16_t raw = (pair == 0) ? ads.readADC_Differential_0_1() : ads.readADC_Differential_2_3();
+    armComparator_();
+    return raw;
+}
+
+void Ads1115Driver::writeRegister_(uint8_t reg, uint16_t value)
+{
+    // Adafruit keeps its register writer protected; same wire format
+    Wire.beginTransmission(addr);
+    Wire.write(reg);
+    Wire.write(uint8_t(value >> 8));
+    Wire.write(uint8_t(value & 0xFF));
+    Wire.endTransmission();
+}
+
+void IRAM_ATTR Ads1115Driver::onWindow_(void *arg)
+{
+    // Excursion outside the window = load present; push the fault deadline out
+    Ads1115Driver *self = static_cast<Ads1115Driver *>(arg);
+    self->cmpEdges++;
+    BaseType_t woken = pdFALSE;
+    xTimerResetFromISR(self->faultTimer, &woken);
+    if (woken)
+        portYIELD_FROM_ISR();
+}
+
+void Ads1115Driver::onFaultTimer_(TimerHandle_t timer)
+{
+    // Timer service task: only flag it, MQTT is published from loop()
+    Ads1115Driver *self = static_cast<Ads1115Driver *>(pvTimerGetTimerID(timer));
+    self->cmpFault = true;
+}
+
+void IRAM_ATTR Ads1115Driver::onReady_(void *arg)
+{
+    // Keep the ISR to a counter bump; the I2C read happens in service()
+    Ads1115Driver *self = static_cast<Ads1115Driver *>(arg);
+    self->readyEdges++;
+    if (self->serviceTask)
+    {
+        BaseType_t woken = pdFALSE;
+        vTaskNotifyGiveFromISR(self->serviceTask, &woken);
+        if (woken)
+            portYIELD_FROM_ISR();
+    }
+}
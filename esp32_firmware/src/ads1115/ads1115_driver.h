@@ -3,6 +3,21 @@
 
 #include <Arduino.h>
 #include <Adafruit_ADS1X15.h>
+#include <freertos/timers.h>
+#include "ads1115/ads1115_traits.h"
+#include "sampling/spsc_ring.h"
+
+// One buffered conversion, timestamped when it was read off the chip.
+// SAMPLE_GAP marks the first sample after a discontinuity (mux slot start,
+// missed RDY edge, ring overflow) so consumers can restart any window that
+// assumes evenly spaced samples.
+struct AdsSample
+{
+    uint32_t tUs;
+    int16_t raw;
+    uint8_t flags;
+};
+static constexpr uint8_t SAMPLE_GAP = 0x01;
 
 class Ads1115Driver {
     public:
@@ -14,18 +29,123 @@ class Ads1115Driver {
         void setGain(adsGain_t gain);
         adsGain_t getGain() const { return currentGain; }
         void setDataRate(uint16_t dataRate);
+        uint16_t getDataRate() const { return currentDataRate; }
+        uint16_t samplesPerSecond() const { return adsSamplesPerSecond(currentDataRate); }
+
+        // Per-pair PGA gain. Applied in the same config write as the mux, so a
+        // pair's gain only costs bus traffic when switching to it needs it.
+        // Set before beginContinuous(); a single streaming pair is not re-armed.
+        void setPairGain(uint8_t pair, adsGain_t gain);
+        adsGain_t getPairGain(uint8_t pair) const { return pair > 1 ? currentGain : pairGain[pair]; }
 
         // Differential pairs: 0 => AIN0-AIN1, 1 => AIN2-AIN3
+        // In continuous mode this returns the next buffered sample for the pair
+        // (servicing the chip until one arrives) instead of a single-shot read.
         int16_t readDiffPair(uint8_t pair) const;
 
-        // Volts per LSB for current gain setting
-        float lsbVolts() const;
+        // Volts per LSB for current gain setting (see adsLsbVolts() for constants)
+        float lsbVolts() const { return adsLsbVolts(currentGain); }
+
+        // ---- Continuous-conversion mode ----
+        // Free-running conversions paced by the ALERT/RDY pin (open-drain, active low).
+        // With both pairs in pairMask the mux alternates pair 0 / pair 1 every
+        // samplesPerPair results so both CTs are covered; the first result after each
+        // mux switch is discarded (settling) and the first kept one is flagged SAMPLE_GAP.
+        bool beginContinuous(uint8_t alertPin, uint16_t samplesPerPair = 32, uint8_t pairMask = 0x03);
+        void stopContinuous();
+        bool isContinuous() const { return continuous; }
+
+        // Mux slot length while streaming; takes effect from the next slot
+        // (waveform capture stretches a slot so one pair runs uninterrupted)
+        void setSamplesPerPair(uint16_t n) { samplesPerPair = n ? n : 1; }
+        uint16_t getSamplesPerPair() const { return samplesPerPair; }
+
+        // ---- Window-comparator fault watch ----
+        // Free-running conversions on one pair with ALERT in non-latching window
+        // mode: every excursion outside [lo, hi] pulses the pin, so a healthy AC
+        // load above threshold toggles it twice per mains cycle. A one-shot
+        // FreeRTOS timer is reset by each edge from the ISR; when edges stop for
+        // faultTimeoutMs it fires and latches comparatorFault (no polling, no I2C).
+        // Uses the same ALERT pin as RDY pacing, so it replaces continuous mode.
+        // readDiffPair() still works: the watched pair reads the free-running
+        // result, the other pair takes a single-shot read and re-arms the window.
+        bool beginComparator(uint8_t alertPin, uint8_t pair, int16_t loCounts, int16_t hiCounts,
+                             uint32_t faultTimeoutMs);
+        void setComparatorWindow(uint8_t pair, int16_t loCounts, int16_t hiCounts); // re-arms the timer
+        void stopComparator();
+        bool isComparator() const { return comparator; }
+        uint8_t comparatorPair() const { return cmpPair; }
+        bool takeComparatorFault();  // true once per timeout, then clears
+        uint32_t comparatorEdges() const { return cmpEdges; }
+
+        // Producer: move a ready conversion from the chip into its pair's ring.
+        // One I2C read per RDY edge; no-op (no bus access) when nothing is pending.
+        void service();
+
+        // Hand service() to a task: the RDY ISR then notifies it (vTaskNotifyGiveFromISR)
+        // and readDiffPair() only waits on the ring. Pass nullptr to service inline again.
+        void setServiceTask(TaskHandle_t task) { serviceTask = task; }
+
+        // Consumer: pop up to maxCount buffered samples for a pair; returns how many were copied.
+        // Lock-free against service() running on the other core.
+        size_t drain(uint8_t pair, AdsSample *out, size_t maxCount);
+        size_t available(uint8_t pair) const;
+
+        // RDY edges we could not read in time + samples dropped on a full ring
+        uint32_t overruns() const { return overrunCount; }
+
+        static constexpr size_t RING_SIZE = 256; // per pair, power of two
+        static constexpr uint8_t NO_ALERT_PIN = 0xFF;
+        static constexpr unsigned long CONTINUOUS_READ_TIMEOUT_MS = 500;
 
     private:
         Adafruit_ADS1115 ads;
         uint8_t addr;
         adsGain_t currentGain;
         uint16_t currentDataRate;
+        adsGain_t pairGain[2];
+
+        // Fixed-size ring of samples (one per differential pair)
+        struct RawRing
+        {
+            SpscRing<AdsSample, RING_SIZE> q;
+            bool gapPending = true; // producer-side: next push starts a new run
+        };
+        RawRing rings[2];
+        TaskHandle_t serviceTask = nullptr;
+
+        // Continuous-mode state
+        bool continuous = false;
+        uint8_t alertPin = NO_ALERT_PIN;
+        volatile uint16_t samplesPerPair = 32; // read by service() on the sampling core
+        uint8_t pairMask = 0x03;
+        uint8_t activePair = 0;
+        uint16_t pairCount = 0;
+        bool discardNext = false;
+        volatile uint32_t readyEdges = 0; // bumped by the ISR
+        uint32_t servicedEdges = 0;
+        uint32_t overrunCount = 0;
+
+        // Comparator-mode state
+        bool comparator = false;
+        uint8_t cmpPair = 0;
+        int16_t cmpLo = 0;
+        int16_t cmpHi = 0;
+        TimerHandle_t faultTimer = nullptr;
+        volatile uint32_t cmpEdges = 0;    // bumped by the ISR
+        volatile bool cmpFault = false;    // set by the timer callback
+
+        void applyPairGain_(uint8_t pair);
+        void startPair_(uint8_t pair);
+        void push_(uint8_t pair, int16_t raw, uint32_t tUs);
+        static uint16_t muxFor_(uint8_t pair);
+        static void IRAM_ATTR onReady_(void *arg);
+
+        void armComparator_();
+        int16_t readWhileComparing_(uint8_t pair);
+        void writeRegister_(uint8_t reg, uint16_t value);
+        static void IRAM_ATTR onWindow_(void *arg);
+        static void onFaultTimer_(TimerHandle_t timer);
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,82 @@
+#ifndef ADS1115_TRAITS_H
+#define ADS1115_TRAITS_H
+
+#include <stdint.h>
+#include <Adafruit_ADS1X15.h>
+
+// Compile-time ADS1115 scale factors. Everything here is constexpr so channel
+// tables can fold gain / rate into constants and reject bad configs with
+// static_assert instead of a runtime switch per reading.
+
+// PGA full-scale range (±V)
+constexpr float adsFullScaleVolts(adsGain_t gain)
+{
+    switch (gain)
+    {
+    case GAIN_TWOTHIRDS:
+        return 6.144f;
+    case GAIN_ONE:
+        return 4.096f;
+    case GAIN_TWO:
+        return 2.048f;
+    case GAIN_FOUR:
+        return 1.024f;
+    case GAIN_EIGHT:
+        return 0.512f;
+    case GAIN_SIXTEEN:
+        return 0.256f;
+    default:
+        return 2.048f;
+    }
+}
+
+// Volts per LSB: full-scale / 32768 (signed 16-bit); GAIN_EIGHT ≈ 15.625 µV
+constexpr float adsLsbVolts(adsGain_t gain)
+{
+    return adsFullScaleVolts(gain) / 32768.0f;
+}
+
+constexpr uint16_t adsSamplesPerSecond(uint16_t dataRate)
+{
+    switch (dataRate)
+    {
+    case RATE_ADS1115_8SPS:
+        return 8;
+    case RATE_ADS1115_16SPS:
+        return 16;
+    case RATE_ADS1115_32SPS:
+        return 32;
+    case RATE_ADS1115_64SPS:
+        return 64;
+    case RATE_ADS1115_250SPS:
+        return 250;
+    case RATE_ADS1115_475SPS:
+        return 475;
+    case RATE_ADS1115_860SPS:
+        return 860;
+    case RATE_ADS1115_128SPS:
+    default:
+        return 128;
+    }
+}
+
+// Nominal conversion period (the internal oscillator is ±10%)
+constexpr uint32_t adsConversionUs(uint16_t dataRate)
+{
+    return 1000000UL / adsSamplesPerSecond(dataRate);
+}
+
+// CT on a burden resistor: amps per count at a given gain
+constexpr float adsAmpsPerCount(adsGain_t gain, float burdenOhms)
+{
+    return adsLsbVolts(gain) / burdenOhms;
+}
+
+// True when a sine of maxRmsA across the burden stays inside the PGA range
+// with some headroom for crest factor / inrush.
+constexpr bool adsGainFits(adsGain_t gain, float burdenOhms, float maxRmsA, float headroom = 0.9f)
+{
+    return maxRmsA * 1.41421356f * burdenOhms <= adsFullScaleVolts(gain) * headroom;
+}
+
+#endif // ADS1115_TRAITS_H
@@ -1,6 +1,6 @@
 #include "auto_mode_manager.h"
 #include "topics.h"
-void AutoModeManager::begin(PubSubClient *mqttClient)
+void AutoModeManager::begin(TelemetryPublisher *mqttClient)
 {
     client = mqttClient;
     loadFromPreferences();
@@ -2,12 +2,12 @@
 #define AUTO_MODE_MANAGER_H
 
 #include <Preferences.h>
-#include <PubSubClient.h>
+#include "mqtt/telemetry_publisher.h"
 
 class AutoModeManager
 {
 public:
-    void begin(PubSubClient *mqttClient);
+    void begin(TelemetryPublisher *mqttClient);
     bool isEnabled() const;
     void setEnabled(bool enabled);
     void toggle();
@@ -18,7 +18,7 @@ public:
 private:
     bool autoModeEnabled = true;
     Preferences preferences;
-    PubSubClient *client;
+    TelemetryPublisher *client;
 };
 
 #endif
@@ -0,0 +1,53 @@
+#include "current_sensor/baseline_tracker.h"
+#include <math.h>
+
+void BaselineTracker::seed(float offsetCounts, float confidence)
+{
+    if (confidence < 0.0f)
+        confidence = 0.0f;
+    if (confidence > 1.0f)
+        confidence = 1.0f;
+    mean = offsetCounts;
+    var = 0.0f;
+    n = uint32_t(lroundf(confidence * WARMUP_WINDOWS));
+}
+
+bool BaselineTracker::fold(float meanCounts, float rmsCounts)
+{
+    if (rmsCounts > IDLE_RMS_MAX_COUNTS)
+        return false; // something is drawing current; not a zero sample
+
+    if (n == 0)
+    {
+        mean = meanCounts;
+        var = 0.0f;
+        n = 1;
+        return true;
+    }
+
+    // 1/(n+1) running average during warm-up, exponential afterwards
+    float alpha = 1.0f / float(n + 1);
+    if (alpha < ALPHA_MIN)
+        alpha = ALPHA_MIN;
+
+    const float diff = meanCounts - mean;
+    mean += alpha * diff;
+    var = (1.0f - alpha) * (var + alpha * diff * diff);
+
+    if (n < 0xFFFFFFFFu)
+        ++n;
+    return true;
+}
+
+float BaselineTracker::spread() const
+{
+    return var > 0.0f ? sqrtf(var) : 0.0f;
+}
+
+float BaselineTracker::confidence() const
+{
+    const float warm = n >= WARMUP_WINDOWS ? 1.0f : float(n) / WARMUP_WINDOWS;
+    const float sd = spread();
+    const float stable = sd <= STABLE_SD_COUNTS ? 1.0f : STABLE_SD_COUNTS / sd;
+    return warm * stable;
+}
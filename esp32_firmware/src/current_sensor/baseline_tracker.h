@@ -0,0 +1,36 @@
+#ifndef BASELINE_TRACKER_H
+#define BASELINE_TRACKER_H
+
+#include <stdint.h>
+
+// Online zero (DC offset) tracking for a CT channel, host-buildable.
+// Fed one window mean at a time while the channel's load is OFF: starts as a
+// running average, then settles into a slow exponential (alpha floor) so drift
+// with temperature is followed without ever blocking for a calibration burst.
+class BaselineTracker
+{
+public:
+    static constexpr uint16_t WARMUP_WINDOWS = 64;     // full confidence after this many folds
+    static constexpr float ALPHA_MIN = 1.0f / 256.0f;  // ~256-window time constant once warm
+    static constexpr float STABLE_SD_COUNTS = 0.5f;    // spread of window means we call "stable"
+    static constexpr float IDLE_RMS_MAX_COUNTS = 8.0f; // reject windows with real AC on them
+
+    // Start from a known offset (e.g. from NVS) as if `confidence` worth of windows were seen
+    void seed(float offsetCounts, float confidence);
+
+    // Fold one OFF-state window (absolute mean counts, AC RMS counts).
+    // Returns false if the window was rejected as not idle.
+    bool fold(float meanCounts, float rmsCounts);
+
+    float offset() const { return mean; }
+    float spread() const;     // EW std-dev of window means (counts)
+    float confidence() const; // 0..1: warm-up progress × stability
+    uint32_t windows() const { return n; }
+
+private:
+    float mean = 0.0f;
+    float var = 0.0f;
+    uint32_t n = 0;
+};
+
+#endif // BASELINE_TRACKER_H
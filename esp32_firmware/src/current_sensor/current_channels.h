@@ -0,0 +1,103 @@
+#ifndef CURRENT_CHANNELS_H
+#define CURRENT_CHANNELS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "topics.h"
+#include "ads1115/ads1115_traits.h"
+
+// ==============================
+// Current channel table (compile time)
+// ==============================
+//
+// One row per ZMCT103C CT. Up to four ADS1115s (0x48..0x4B, selected with the
+// ADDR pin) give 8 differential channels. To add a pump or filter: wire the CT,
+// add a row, give it a topic in topics.h. Status/peak/crest topics are derived
+// from the row's topic ("<topic>/status", ...).
+
+// Supply voltage used for energy accounting (Wh = V * I_rms * PF * h)
+static constexpr float MAINS_VOLTS = 120.0f;
+
+// Which output must be ON for a channel to be measured (OFF is announced otherwise)
+enum class CurrentGate : uint8_t
+{
+    Always, // pumps, filters: always expected to draw
+    Lights, // either lamp
+    Heat,   // basking lamp relay
+    Uv      // UV lamp relay
+};
+
+struct CurrentChannelConfig
+{
+    uint8_t chip;      // ADS1115 index: address 0x48 + chip
+    uint8_t pair;      // 0 => AIN0-AIN1, 1 => AIN2-AIN3
+    float burdenOhms;  // trimmed burden resistor
+    adsGain_t gain;    // PGA for this pair (switched with the mux)
+    float maxA;        // largest RMS the channel must read unclipped
+    float thresholdA;  // RMS above this → "OK", otherwise "FLT"
+    const char *name;  // label for logs
+    const char *topic; // RMS amps; base for derived topics
+    CurrentGate gate;
+    float powerFactor; // 1.0 for incandescent/ceramic; < 1 for ballasted lamps
+};
+
+// ALERT/RDY GPIO per chip (0x48..0x4B); 0xFF = not wired → blocking single-shot reads
+static constexpr uint8_t ADS_ALERT_PINS[] = {6, 0xFF, 0xFF, 0xFF};
+static constexpr uint8_t ADS_MAX_CHIPS = sizeof(ADS_ALERT_PINS) / sizeof(ADS_ALERT_PINS[0]);
+static constexpr uint8_t ADS_BASE_ADDR = 0x48;
+
+static constexpr CurrentChannelConfig CURRENT_CHANNELS[] = {
+    // chip pair burden gain          maxA   thresh  name    topic               gate               PF
+    {0, 0, 0.50f, GAIN_EIGHT, 0.65f, 0.20f, "Heat", TOPIC_CURRENT_HEAT, CurrentGate::Heat, 1.0f}, // ~0.43 A (50 W)
+    {0, 1, 0.50f, GAIN_SIXTEEN, 0.30f, 0.05f, "UV", TOPIC_CURRENT_UV, CurrentGate::Uv, 1.0f},     // ~0.11 A (13 W)
+    // {1, 0, 0.50f, GAIN_EIGHT, 0.50f, 0.10f, "Pump", TOPIC_CURRENT_PUMP, CurrentGate::Always, 0.8f},
+};
+static constexpr size_t CURRENT_CHANNEL_COUNT = sizeof(CURRENT_CHANNELS) / sizeof(CURRENT_CHANNELS[0]);
+
+// Bitmask of pairs used on a chip (drives mux rotation)
+constexpr uint8_t currentPairMask(uint8_t chip)
+{
+    uint8_t mask = 0;
+    for (size_t i = 0; i < CURRENT_CHANNEL_COUNT; ++i)
+    {
+        if (CURRENT_CHANNELS[i].chip == chip)
+            mask |= uint8_t(1u << CURRENT_CHANNELS[i].pair);
+    }
+    return mask;
+}
+
+// Every row's maxA (as a sine peak across its burden) must fit its PGA range
+constexpr bool currentGainsFit()
+{
+    for (size_t i = 0; i < CURRENT_CHANNEL_COUNT; ++i)
+    {
+        const CurrentChannelConfig &c = CURRENT_CHANNELS[i];
+        if (c.maxA <= c.thresholdA || !adsGainFits(c.gain, c.burdenOhms, c.maxA))
+            return false;
+    }
+    return true;
+}
+
+constexpr bool currentChannelsValid()
+{
+    for (size_t i = 0; i < CURRENT_CHANNEL_COUNT; ++i)
+    {
+        const CurrentChannelConfig &c = CURRENT_CHANNELS[i];
+        if (c.chip >= ADS_MAX_CHIPS || c.pair > 1 || c.burdenOhms <= 0.0f || !c.topic ||
+            c.powerFactor <= 0.0f || c.powerFactor > 1.0f)
+            return false;
+        for (size_t j = i + 1; j < CURRENT_CHANNEL_COUNT; ++j)
+        {
+            if (CURRENT_CHANNELS[j].chip == c.chip && CURRENT_CHANNELS[j].pair == c.pair)
+                return false; // two rows on the same input
+        }
+    }
+    return true;
+}
+
+static_assert(CURRENT_CHANNEL_COUNT > 0 && CURRENT_CHANNEL_COUNT <= 2 * ADS_MAX_CHIPS,
+              "1..8 current channels supported");
+static_assert(currentChannelsValid(), "CURRENT_CHANNELS: bad chip/pair/burden/PF or duplicate input");
+static_assert(currentGainsFit(), "CURRENT_CHANNELS: maxA * 1.414 * burden exceeds the PGA range (lower the gain)");
+
+#endif // CURRENT_CHANNELS_H
@@ -1,53 +1,147 @@
 #include "current_sensor/current_sensor_manager.h"
-#include <PubSubClient.h>
+#include "mqtt/telemetry_publisher.h"
+#include <Preferences.h>
 #include "lights/light_manager.h"
 #include "feeder/feeder_manager.h"
 #include "topics.h"
 
-CurrentSensorManager::CurrentSensorManager(uint8_t adsAddr)
-    : ads(adsAddr),
-      heat(ads, 0, "Heat", 0.5f, 0.20f),
-      uv(ads, 1, "UV", 0.5f, 0.05f)
+// Publish deadbands (TelemetryPublisher heartbeat refreshes the rest)
+static constexpr float AMPS_DEADBAND = 0.02f;          // ~2.4 W at 120 V
+static constexpr float CREST_DEADBAND = 0.05f;
+static constexpr float ENERGY_DEADBAND_WH = 1.0f;
+static constexpr float ON_TIME_DEADBAND_S = 60.0f;
+static constexpr float BASELINE_DEADBAND_COUNTS = 0.5f;
+
+CurrentSensorManager::CurrentSensorManager()
+    : CurrentSensorManager(std::make_index_sequence<ADS_MAX_CHIPS>{},
+                           std::make_index_sequence<CURRENT_CHANNEL_COUNT>{})
+{
+}
+
+template <size_t... C, size_t... I>
+CurrentSensorManager::CurrentSensorManager(std::index_sequence<C...>, std::index_sequence<I...>)
+    : chips{Ads1115Driver(uint8_t(ADS_BASE_ADDR + C))...},
+      sensors{Zmct103cSensor(chips[CURRENT_CHANNELS[I].chip],
+                             CURRENT_CHANNELS[I].pair,
+                             CURRENT_CHANNELS[I].name,
+                             CURRENT_CHANNELS[I].burdenOhms,
+                             CURRENT_CHANNELS[I].thresholdA,
+                             CURRENT_CHANNELS[I].gain)...}
 {
 }
 
-void CurrentSensorManager::begin(PubSubClient &mqttClient,
+void CurrentSensorManager::begin(TelemetryPublisher &telemetry,
                                  LightManager &lightsRef,
                                  FeederManager &feederRef,
-                                 unsigned long publishIntervalMs,
-                                 float burdenHeat,
-                                 float burdenUV,
-                                 float thHeatA,
-                                 float thUvA)
+                                 unsigned long publishIntervalMs)
 {
-    mqtt = &mqttClient;
+    mqtt = &telemetry;
     lights = &lightsRef;
     feeder = &feederRef;
 
     intervalMs = publishIntervalMs;
 
-    if (!ads.begin(GAIN_EIGHT, RATE_ADS1115_128SPS))
+    // Bring up only the chips the table uses
+    bool any = false;
+    for (uint8_t c = 0; c < ADS_MAX_CHIPS; ++c)
+    {
+        const uint8_t mask = currentPairMask(c);
+        if (!mask)
+            continue;
+
+        chipReady[c] = chips[c].begin(GAIN_EIGHT, RATE_ADS1115_128SPS);
+        if (!chipReady[c])
+        {
+            Serial.printf("[Current] ADS1115 @0x%02X not found\n", ADS_BASE_ADDR + c);
+            continue;
+        }
+        any = true;
+
+        // Each pair carries its own PGA; the driver switches it with the mux
+        for (size_t i = 0; i < CURRENT_CHANNEL_COUNT; ++i)
+        {
+            if (CURRENT_CHANNELS[i].chip == c)
+                chips[c].setPairGain(CURRENT_CHANNELS[i].pair, CURRENT_CHANNELS[i].gain);
+        }
+
+        // ALERT/RDY-paced streaming if the pin is wired; otherwise blocking single-shot reads
+        if (continuousRequested && ADS_ALERT_PINS[c] != Ads1115Driver::NO_ALERT_PIN)
+        {
+            chips[c].setDataRate(adsDataRate);
+            uint16_t window = 0;
+            for (size_t i = 0; i < CURRENT_CHANNEL_COUNT; ++i)
+            {
+                if (CURRENT_CHANNELS[i].chip == c)
+                    window = sensors[i].configureStream(mainsFreqHz);
+            }
+            chips[c].beginContinuous(ADS_ALERT_PINS[c], window, mask); // one RMS window per mux slot
+            chipSlot[c] = window;
+        }
+        else if (faultWatchRequested && ADS_ALERT_PINS[c] != Ads1115Driver::NO_ALERT_PIN)
+        {
+            chips[c].setDataRate(faultWatchRate);
+            watch[c].ch = 0; // armed below, once offsets are loaded
+        }
+    }
+    if (!any)
     {
         ready = false;
         return;
     }
 
-    heat.setBurdenOhms(burdenHeat);
-    uv.setBurdenOhms(burdenUV);
-    heat.setThresholdA(thHeatA);
-    uv.setThresholdA(thUvA);
+    // Warm boot: learned offsets from NVS, no calibration burst
+    loadBaselines_();
 
-    // Initial auto-zero (ideally lights are OFF here)
-    heat.calibrateOffset(100, 5);
-    uv.calibrateOffset(100, 5);
+    // Comparator windows are centred on the learned zero
+    for (uint8_t c = 0; c < ADS_MAX_CHIPS; ++c)
+    {
+        if (watch[c].ch >= 0)
+            beginFaultWatch_(c);
+    }
 
-    wasLightsOn = lights->isOn();
-    if (!wasLightsOn)
+    // Capture buffer is allocated once, up front, and only if something streams
+    for (uint8_t c = 0; c < ADS_MAX_CHIPS; ++c)
     {
-        lightsOffSinceMs = millis();
+        if (chipSlot[c] && capture.begin())
+        {
+            Serial.printf("[Current] capture buffer: %u samples (%s)\n",
+                          capture.capacity(), capture.inPsram() ? "PSRAM" : "DRAM");
+            break;
+        }
     }
 
-    lastRunMs = millis();
+    for (size_t i = 0; i < CURRENT_CHANNEL_COUNT; ++i)
+    {
+        ChannelState &st = state[i];
+        const char *base = CURRENT_CHANNELS[i].topic;
+        snprintf(st.topicStatus, TOPIC_LEN, "%s/status", base);
+        snprintf(st.topicPeak, TOPIC_LEN, "%s/peak", base);
+        snprintf(st.topicCrest, TOPIC_LEN, "%s/crest", base);
+        snprintf(st.topicBaseline, TOPIC_LEN, "%s/baseline", base);
+        snprintf(st.topicHealth, TOPIC_LEN, "%s/health", base);
+        snprintf(st.topicEnergy, TOPIC_LEN, "%s/energy_wh", base);
+        snprintf(st.topicOnTime, TOPIC_LEN, "%s/on_seconds", base);
+        snprintf(st.topicCapture, TOPIC_LEN, "%s/capture", base);
+        snprintf(st.topicHarmonics, TOPIC_LEN, "%s/harmonics", base);
+
+        // Cold boot on a chip that cannot stream: one blocking auto-zero.
+        // Streaming channels learn the zero online (RMS removes the window mean,
+        // so readings are right before the baseline converges).
+        if (chipReady[CURRENT_CHANNELS[i].chip] && isnan(st.savedOffset) && !sensors[i].isStreaming())
+            sensors[i].calibrateOffset(100, 5);
+
+        st.wasOn = isGateOn_(i);
+        st.offSinceMs = st.wasOn ? 0 : millis();
+        if (st.wasOn)
+            sensors[i].startRun();
+    }
+
+    nextChannel = 0;
+    lastSlotMs = millis();
+    lastPersistMs = millis();
+    lastEnergyMs = millis();
+    lastEnergyPersistMs = millis();
+    lastHarmonicsMs = millis();
     ready = true;
 }
 
@@ -62,27 +156,17 @@ void CurrentSensorManager::publishNow()
     if (feeder->isRunning())
         return;
 
-    // Mute when lights are OFF
-    if (muteLightsOff && !lights->isOn())
+    for (size_t i = 0; i < CURRENT_CHANNEL_COUNT; ++i)
     {
-        if (!offAnnounced)
-        {
-            mqtt->publish(TOPIC_CURRENT_HEAT_STATUS, "OFF", true);
-            mqtt->publish(TOPIC_CURRENT_UV_STATUS, "OFF", true);
-            mqtt->publish(TOPIC_CURRENT_HEAT, "0.00", true);
-            mqtt->publish(TOPIC_CURRENT_UV, "0.00", true);
-            offAnnounced = true;
-        }
-        // no currents while OFF
-        lastRunMs = millis();
-        return;
+        if (isGateOn_(i))
+            sampleAndPublish_(i);
+        else
+            announceOff_(i);
     }
 
-    sampleAndPublish_(heat, lastHeat, TOPIC_CURRENT_HEAT, TOPIC_CURRENT_HEAT_STATUS);
-    sampleAndPublish_(uv, lastUv, TOPIC_CURRENT_UV, TOPIC_CURRENT_UV_STATUS);
-
-    // Reset interval timer
-    lastRunMs = millis();
+    // Restart the round-robin cadence
+    nextChannel = 0;
+    lastSlotMs = millis();
 }
 
 void CurrentSensorManager::readAndPublish()
@@ -94,90 +178,700 @@ void CurrentSensorManager::readAndPublish()
 
     const unsigned long now = millis();
 
-    // Auto-zero logic based on lights state
-    trackLightsForAutoZero_(now);
+    // Gate edges first (startRun / idle), so the windows drained below are
+    // classified against the current output state
+    trackGatesForAutoZero_(now);
+
+    // Keep the rings drained even while muted so windows stay fresh
+    pollStreams_();
+
+    serviceFaultWatch_(now);
+    serviceCapture_(now);
+
+    // Energy keeps counting while the feeder mutes publishing
+    accumulateEnergy_(now);
+
+    persistIfDue_(now);
+    if (now - lastEnergyPersistMs >= energyPersistMs)
+    {
+        lastEnergyPersistMs = now;
+        persistEnergy_(false);
+    }
 
     // Safety: skip while feeder is running
     if (feeder->isRunning())
         return;
 
-    // Mute when lights are OFF
-    if (muteLightsOff && !lights->isOn())
+    // Health transitions go out now, not on the channel's next slot
+    publishHealthChanges_();
+
+    // Mute channels whose output is OFF (announced once per transition)
+    for (size_t i = 0; i < CURRENT_CHANNEL_COUNT; ++i)
+    {
+        if (!isGateOn_(i))
+            announceOff_(i);
+    }
+
+    // Round-robin: one channel per slot, each channel every intervalMs
+    const unsigned long slotMs = intervalMs / CURRENT_CHANNEL_COUNT;
+    if (now - lastSlotMs < slotMs)
+        return;
+    lastSlotMs = now;
+
+    const size_t ch = nextChannel;
+    nextChannel = (nextChannel + 1) % CURRENT_CHANNEL_COUNT;
+
+    if (isGateOn_(ch))
+        sampleAndPublish_(ch);
+    publishBaseline_(ch);
+    publishEnergy_(ch);
+}
+
+bool CurrentSensorManager::isGateOn_(size_t ch) const
+{
+    switch (CURRENT_CHANNELS[ch].gate)
+    {
+    case CurrentGate::Lights:
+        return lights->isOn();
+    case CurrentGate::Heat:
+        return lights->isHeatOn();
+    case CurrentGate::Uv:
+        return lights->isUVOn();
+    case CurrentGate::Always:
+    default:
+        return true;
+    }
+}
+
+void CurrentSensorManager::announceOff_(size_t ch)
+{
+    ChannelState &st = state[ch];
+    if (st.offAnnounced)
+        return;
+    mqtt->publish(st.topicStatus, "OFF", true);
+    mqtt->publish(CURRENT_CHANNELS[ch].topic, "0.00", true);
+    st.lastA = 0.0f;
+    st.offAnnounced = true;
+}
+
+void CurrentSensorManager::sampleAndPublish_(size_t ch)
+{
+    if (!chipReady[CURRENT_CHANNELS[ch].chip])
+        return;
+
+    Zmct103cSensor &s = sensors[ch];
+    ChannelState &st = state[ch];
+
+    if (s.isStreaming())
     {
-        if (!offAnnounced)
+        st.lastA = s.takeCurrentA();
+    }
+    else
+    {
+        st.lastA = s.readCurrentA();
+        s.updateHealth(st.lastA);
+    }
+    st.offAnnounced = false;
+
+    mqtt->publishValue(CURRENT_CHANNELS[ch].topic, st.lastA, 2, AMPS_DEADBAND);
+
+    // Peak / crest only exist for whole-cycle windows (continuous mode)
+    if (s.isStreaming())
+    {
+        mqtt->publishValue(st.topicPeak, s.getPeakA(), 2, AMPS_DEADBAND);
+        mqtt->publishValue(st.topicCrest, s.getCrestFactor(), 2, CREST_DEADBAND);
+    }
+
+    const bool ok = (st.lastA > s.getThresholdA()) && s.getHealth() != DriftDetector::Health::Fail;
+    mqtt->publish(st.topicStatus, ok ? "OK" : "FLT", true);
+    mqtt->publish(st.topicHealth, DriftDetector::toString(s.getHealth()), true);
+    s.takeHealthChange(); // just published
+}
+
+void CurrentSensorManager::publishHealthChanges_()
+{
+    for (size_t i = 0; i < CURRENT_CHANNEL_COUNT; ++i)
+    {
+        Zmct103cSensor &s = sensors[i];
+        if (!isGateOn_(i) || !s.takeHealthChange())
+            continue;
+
+        const DriftDetector::Health h = s.getHealth();
+        mqtt->publish(state[i].topicHealth, DriftDetector::toString(h), true);
+        if (h == DriftDetector::Health::Fail)
+        {
+            mqtt->publish(state[i].topicStatus, "FLT", true);
+            Serial.printf("[Current] %s: FAIL (abrupt drop)\n", s.getName());
+        }
+        else if (h == DriftDetector::Health::Degrading)
         {
-            mqtt->publish(TOPIC_CURRENT_HEAT_STATUS, "OFF", true);
-            mqtt->publish(TOPIC_CURRENT_UV_STATUS, "OFF", true);
-            mqtt->publish(TOPIC_CURRENT_HEAT, "0.00", true);
-            mqtt->publish(TOPIC_CURRENT_UV, "0.00", true);
-            offAnnounced = true;
+            Serial.printf("[Current] %s: DEGRADING (ref %.3f A, ewma %.3f A)\n", s.getName(),
+                          s.driftDetector().referenceA(), s.driftDetector().ewmaA());
         }
-        // no currents while OFF
-        lastRunMs = millis();
+    }
+}
+
+void CurrentSensorManager::resetDriftReference(size_t ch)
+{
+    if (ch >= CURRENT_CHANNEL_COUNT)
         return;
+    sensors[ch].driftDetector().resetReference();
+    state[ch].refSaved = false;
+
+    Preferences prefs;
+    if (prefs.begin("ct_ref", false))
+    {
+        char key[8];
+        baselineKey_(ch, key, sizeof(key));
+        prefs.remove(key);
+        prefs.end();
     }
+}
 
-    // Timer
-    if (now - lastRunMs < intervalMs)
+void CurrentSensorManager::accumulateEnergy_(unsigned long now)
+{
+    const uint32_t dtMs = now - lastEnergyMs;
+    lastEnergyMs = now;
+    if (dtMs == 0)
         return;
-    lastRunMs = now;
 
-    // Read + publish both channels
-    sampleAndPublish_(heat, lastHeat, TOPIC_CURRENT_HEAT, TOPIC_CURRENT_HEAT_STATUS);
-    sampleAndPublish_(uv, lastUv, TOPIC_CURRENT_UV, TOPIC_CURRENT_UV_STATUS);
+    for (size_t i = 0; i < CURRENT_CHANNEL_COUNT; ++i)
+    {
+        if (!isGateOn_(i) || !chipReady[CURRENT_CHANNELS[i].chip])
+            continue; // OFF windows are zero-tracking noise, not load
+
+        ChannelState &st = state[i];
+        const Zmct103cSensor &s = sensors[i];
+        const float amps = s.isStreaming() ? s.getWindowA() : st.lastA;
+
+        st.energy.wh += double(mainsVolts * amps * CURRENT_CHANNELS[i].powerFactor) * dtMs / 3600000.0;
+        if (amps > s.getThresholdA())
+        {
+            st.onMsFrac += dtMs;
+            st.energy.onSec += st.onMsFrac / 1000;
+            st.onMsFrac %= 1000;
+        }
+        st.energyDirty = true;
+    }
 }
 
-void CurrentSensorManager::sampleAndPublish_(Zmct103cSensor &s, float &lastA,
-                                             const char *topicCur, const char *topicStat)
+void CurrentSensorManager::publishEnergy_(size_t ch)
 {
-    lastA = s.readCurrentA();
+    const ChannelState &st = state[ch];
+    char buf[24];
+    mqtt->publishValue(st.topicEnergy, float(st.energy.wh), 2, ENERGY_DEADBAND_WH);
+    snprintf(buf, sizeof(buf), "%lu", (unsigned long)st.energy.onSec);
+    mqtt->publishIfMoved(st.topicOnTime, buf, float(st.energy.onSec), ON_TIME_DEADBAND_S);
+}
 
-    if (topicCur && topicCur[0])
+void CurrentSensorManager::resetOnTime(size_t ch)
+{
+    if (ch >= CURRENT_CHANNEL_COUNT)
+        return;
+    state[ch].energy.onSec = 0;
+    state[ch].onMsFrac = 0;
+    state[ch].energyDirty = true;
+    persistEnergy_(true);
+}
+
+void CurrentSensorManager::persistEnergy_(bool force)
+{
+    // One NVS session for all dirty channels; callers rate-limit (energyPersistMs)
+    Preferences prefs;
+    bool open = false;
+    for (size_t i = 0; i < CURRENT_CHANNEL_COUNT; ++i)
     {
-        mqtt->publish(topicCur, String(lastA, 2).c_str(), true);
+        ChannelState &st = state[i];
+        if (!st.energyDirty && !force)
+            continue;
+        if (!open)
+            open = prefs.begin("ct_energy", false); // RW
+        if (!open)
+            return;
+        char key[8];
+        baselineKey_(i, key, sizeof(key));
+        prefs.putBytes(key, &st.energy, sizeof(EnergyTotals));
+        st.energyDirty = false;
     }
+    if (open)
+        prefs.end();
+}
 
-    if (topicStat && topicStat[0])
+void CurrentSensorManager::trackGatesForAutoZero_(unsigned long now)
+{
+    for (size_t i = 0; i < CURRENT_CHANNEL_COUNT; ++i)
     {
-        if (!lights->isOn())
+        ChannelState &st = state[i];
+        const bool on = isGateOn_(i);
+
+        // ON → OFF edge detection
+        if (st.wasOn && !on)
         {
-            mqtt->publish(topicStat, "OFF", true);
+            st.offSinceMs = now;
+            st.offAnnounced = false;
+            sensors[i].takeHealthChange(); // unpublished change is stale once OFF
         }
-        else
+
+        if (!st.wasOn && on)
         {
-            const bool ok = (lastA > s.getThresholdA());
-            mqtt->publish(topicStat, ok ? "OK" : "FLT", true);
+            st.offAnnounced = false;
+            sensors[i].startRun(); // skip inrush / warm-up windows
         }
+
+        st.wasOn = on;
+
+        // OFF and quiet long enough → windows feed the baseline (non-blocking)
+        const bool idle = autoZero && !on && (now - st.offSinceMs >= autoZeroQuietMs);
+        sensors[i].setIdle(idle);
     }
 }
 
-void CurrentSensorManager::trackLightsForAutoZero_(unsigned long now)
+void CurrentSensorManager::publishBaseline_(size_t ch)
 {
-    const bool on = lights->isOn();
+    if (!sensors[ch].isStreaming())
+        return;
+    char buf[48];
+    snprintf(buf, sizeof(buf), "{\"counts\":%.2f,\"conf\":%.2f}",
+             sensors[ch].getOffsetCounts(), sensors[ch].getBaselineConfidence());
+    mqtt->publishIfMoved(state[ch].topicBaseline, buf, sensors[ch].getOffsetCounts(), BASELINE_DEADBAND_COUNTS);
+}
 
-    // ON → OFF edge detection
-    if (wasLightsOn && !on)
+void CurrentSensorManager::loadBaselines_()
+{
+    Preferences prefs;
+    prefs.begin("ct_zero", true); // RO
+    for (size_t i = 0; i < CURRENT_CHANNEL_COUNT; ++i)
     {
-        lightsOffSinceMs = now;
-        offAnnounced = false;
+        char key[8];
+        baselineKey_(i, key, sizeof(key));
+        if (!prefs.isKey(key))
+            continue;
+        const float v = prefs.getFloat(key, 0.0f);
+        state[i].savedOffset = v;
+        sensors[i].seedOffset(v, BASELINE_WARM_BOOT_CONF);
     }
+    prefs.end();
 
-    if (!wasLightsOn && on)
+    // Learned healthy references keep slow lamp drift visible across reboots
+    prefs.begin("ct_ref", true); // RO
+    for (size_t i = 0; i < CURRENT_CHANNEL_COUNT; ++i)
     {
-        offAnnounced = false;
+        char key[8];
+        baselineKey_(i, key, sizeof(key));
+        DriftDetector::Reference ref;
+        if (prefs.getBytesLength(key) == sizeof(ref) && prefs.getBytes(key, &ref, sizeof(ref)) == sizeof(ref))
+        {
+            sensors[i].driftDetector().restoreReference(ref);
+            state[i].refSaved = true;
+        }
     }
+    prefs.end();
+
+    // Energy / lamp-hour totals
+    prefs.begin("ct_energy", true); // RO
+    for (size_t i = 0; i < CURRENT_CHANNEL_COUNT; ++i)
+    {
+        char key[8];
+        baselineKey_(i, key, sizeof(key));
+        EnergyTotals e;
+        if (prefs.getBytesLength(key) == sizeof(e) && prefs.getBytes(key, &e, sizeof(e)) == sizeof(e))
+            state[i].energy = e;
+    }
+    prefs.end();
+}
+
+void CurrentSensorManager::persistIfDue_(unsigned long now)
+{
+    // Coalesced: one NVS session per period, only for confident, moved offsets
+    if (now - lastPersistMs < BASELINE_PERSIST_MS)
+        return;
+    lastPersistMs = now;
 
-    wasLightsOn = on;
+    Preferences prefs;
+    bool open = false;
+    for (size_t i = 0; i < CURRENT_CHANNEL_COUNT; ++i)
+    {
+        const Zmct103cSensor &s = sensors[i];
+        ChannelState &st = state[i];
+        if (s.getBaselineConfidence() < BASELINE_PERSIST_MIN_CONF)
+            continue;
+        const float v = s.getOffsetCounts();
+        if (!isnan(st.savedOffset) && fabsf(v - st.savedOffset) < BASELINE_PERSIST_MIN_DELTA)
+            continue;
 
-    // If lights are OFF and it's been quiet long enough, re-zero
-    if (autoZero && !on)
+        if (!open)
+            open = prefs.begin("ct_zero", false); // RW
+        if (!open)
+            return;
+        char key[8];
+        baselineKey_(i, key, sizeof(key));
+        prefs.putFloat(key, v);
+        st.savedOffset = v;
+    }
+    if (open)
+        prefs.end();
+
+    // Drift references: written once, when learning completes
+    open = false;
+    for (size_t i = 0; i < CURRENT_CHANNEL_COUNT; ++i)
     {
-        if (lightsOffSinceMs && (now - lightsOffSinceMs >= autoZeroQuietMs))
+        DriftDetector &d = sensors[i].driftDetector();
+        if (state[i].refSaved || !d.isLearned())
+            continue;
+        if (!open)
+            open = prefs.begin("ct_ref", false); // RW
+        if (!open)
+            return;
+        char key[8];
+        baselineKey_(i, key, sizeof(key));
+        prefs.putBytes(key, &d.reference(), sizeof(DriftDetector::Reference));
+        state[i].refSaved = true;
+    }
+    if (open)
+        prefs.end();
+}
+
+void CurrentSensorManager::acquire()
+{
+    for (uint8_t c = 0; c < ADS_MAX_CHIPS; ++c)
+    {
+        if (chipReady[c])
+            chips[c].service(); // no bus traffic unless that chip raised RDY
+    }
+}
+
+uint32_t CurrentSensorManager::getAdsOverruns() const
+{
+    uint32_t n = 0;
+    for (uint8_t c = 0; c < ADS_MAX_CHIPS; ++c)
+        n += chips[c].overruns();
+    return n;
+}
+
+void CurrentSensorManager::setAcquisitionTask(TaskHandle_t task)
+{
+    for (Ads1115Driver &chip : chips)
+        chip.setServiceTask(task);
+    externalAcquire = (task != nullptr);
+}
+
+void CurrentSensorManager::pollStreams_()
+{
+    if (!externalAcquire)
+        acquire();
+    for (size_t i = 0; i < CURRENT_CHANNEL_COUNT; ++i)
+    {
+        if (sensors[i].isStreaming())
+            sensors[i].poll(isGateOn_(i));
+    }
+}
+
+void CurrentSensorManager::faultWindow_(size_t ch, int16_t &lo, int16_t &hi) const
+{
+    // A sine at thresholdA RMS just reaches ±thresholdA·√2; anything healthier leaves the window
+    const Zmct103cSensor &s = sensors[ch];
+    const float half = s.getThresholdA() * 1.41421356f / s.getAmpsPerCount();
+    const float off = s.getOffsetCounts();
+    lo = int16_t(constrain(lroundf(off - half), -32768L, 32767L));
+    hi = int16_t(constrain(lroundf(off + half), -32768L, 32767L));
+}
+
+void CurrentSensorManager::beginFaultWatch_(uint8_t c)
+{
+    // First row on this chip; serviceFaultWatch_() retargets to whichever is powered
+    FaultWatch &w = watch[c];
+    for (size_t i = 0; i < CURRENT_CHANNEL_COUNT; ++i)
+    {
+        if (CURRENT_CHANNELS[i].chip == c)
         {
-            heat.calibrateOffset(60, 3);
-            uv.calibrateOffset(60, 3);
-            // Prevent repeated re-zero until lights toggle again
-            lightsOffSinceMs = 0;
+            w.ch = int8_t(i);
+            break;
         }
     }
+    faultWindow_(w.ch, w.lo, w.hi);
+    const uint32_t timeoutMs = (1000UL * FAULT_WATCH_CYCLES + mainsFreqHz - 1) / mainsFreqHz;
+    if (!chips[c].beginComparator(ADS_ALERT_PINS[c], CURRENT_CHANNELS[w.ch].pair, w.lo, w.hi, timeoutMs))
+    {
+        w.ch = -1;
+        return;
+    }
+    w.gateOn = isGateOn_(w.ch);
+    w.sinceMs = millis();
+    Serial.printf("[Current] ADS1115 @0x%02X: window comparator on %s (%lu ms)\n",
+                  ADS_BASE_ADDR + c, CURRENT_CHANNELS[w.ch].name, (unsigned long)timeoutMs);
+}
+
+void CurrentSensorManager::serviceFaultWatch_(unsigned long now)
+{
+    for (uint8_t c = 0; c < ADS_MAX_CHIPS; ++c)
+    {
+        FaultWatch &w = watch[c];
+        if (w.ch < 0 || !chips[c].isComparator())
+            continue;
+
+        // Watch the first powered channel on the chip
+        int8_t target = w.ch;
+        for (size_t i = 0; i < CURRENT_CHANNEL_COUNT; ++i)
+        {
+            if (CURRENT_CHANNELS[i].chip == c && isGateOn_(i))
+            {
+                target = int8_t(i);
+                break;
+            }
+        }
+
+        // Retarget / follow threshold and zero changes (re-arming restarts the deadline)
+        int16_t lo, hi;
+        faultWindow_(target, lo, hi);
+        if (target != w.ch || lo != w.lo || hi != w.hi)
+        {
+            w.ch = target;
+            w.lo = lo;
+            w.hi = hi;
+            chips[c].setComparatorWindow(CURRENT_CHANNELS[target].pair, lo, hi);
+            w.sinceMs = now;
+            w.settled = false;
+        }
+
+        const bool on = isGateOn_(w.ch);
+        if (on && !w.gateOn)
+        {
+            w.sinceMs = now; // turn-on: let the lamp settle first
+            w.settled = false;
+        }
+        w.gateOn = on;
+
+        // The one-shot deadline may have expired while OFF / starting; restart it
+        // once so a lamp that never lights still faults
+        if (on && !w.settled && now - w.sinceMs >= FAULT_WATCH_SETTLE_MS)
+        {
+            chips[c].setComparatorWindow(CURRENT_CHANNELS[w.ch].pair, w.lo, w.hi);
+            w.settled = true;
+        }
+
+        if (!chips[c].takeComparatorFault())
+            continue;
+        if (!on || !w.settled)
+            continue; // OFF or still starting: no edges expected yet
+
+        // Immediate, not on the channel's next slot
+        mqtt->publish(state[w.ch].topicStatus, "FLT", true);
+        Serial.printf("[Current] %s: FLT (no comparator edges)\n", CURRENT_CHANNELS[w.ch].name);
+    }
+}
+
+bool CurrentSensorManager::requestCapture(int ch, uint8_t cycles)
+{
+    if (!ready || captureCh >= 0 || captureQueue || capture.capacity() == 0)
+        return false;
+
+    cycles = cycles ? cycles : CAPTURE_DEFAULT_CYCLES;
+    uint8_t mask = 0;
+    for (size_t i = 0; i < CURRENT_CHANNEL_COUNT; ++i)
+    {
+        // arm() would refuse an empty run; nack now rather than ack and go silent
+        if ((ch == CAPTURE_ALL || size_t(ch) == i) && sensors[i].isStreaming() && captureSamples_(i, cycles) > 0)
+            mask |= uint8_t(1u << i);
+    }
+    if (!mask)
+    {
+        publishCaptureStatus_("error", "not streaming");
+        return false;
+    }
+
+    captureQueue = mask;
+    captureCycles = cycles;
+    captureStream = true;
+    return true;
+}
+
+int CurrentSensorManager::findChannel(const char *name) const
+{
+    if (!name)
+        return -1;
+    for (size_t i = 0; i < CURRENT_CHANNEL_COUNT; ++i)
+    {
+        if (strcasecmp(name, CURRENT_CHANNELS[i].name) == 0)
+            return int(i);
+    }
+    return -1;
+}
+
+void CurrentSensorManager::serviceCapture_(unsigned long now)
+{
+    // Next queued channel: stretch its chip's mux slot so the run is contiguous
+    if (captureCh < 0)
+    {
+        if (!captureQueue)
+            scheduleHarmonics_(now);
+        if (!captureQueue)
+            return;
+        size_t ch = 0;
+        while (!(captureQueue & (1u << ch)))
+            ++ch;
+        captureQueue &= uint8_t(~(1u << ch));
+
+        Zmct103cSensor &s = sensors[ch];
+        Ads1115Driver &chip = chips[CURRENT_CHANNELS[ch].chip];
+        const uint16_t sps = chip.samplesPerSecond();
+        const uint32_t want = captureSamples_(ch, captureCycles);
+        const bool rotating = currentPairMask(CURRENT_CHANNELS[ch].chip) == 0x03;
+        if (!capture.arm(uint8_t(ch), uint16_t(want > 0xFFFF ? 0xFFFF : want), sps,
+                         s.getAmpsPerCount(), s.getOffsetCounts(), !rotating))
+        {
+            // Already acked as applied: the requester must still hear an outcome
+            if (captureStream)
+                publishCaptureStatus_("error", "arm failed");
+            return; // next queued channel on the next tick
+        }
+
+        // Whole RMS windows per slot, so the RMS engine is not disturbed
+        const uint16_t win = chipSlot[CURRENT_CHANNELS[ch].chip];
+        const uint16_t n = capture.capacity() < want ? capture.capacity() : uint16_t(want);
+        chip.setSamplesPerPair(uint16_t((n + win - 1) / win * win));
+        s.setCaptureTap(&capture);
+
+        captureCh = int8_t(ch);
+        captureAnalyzed = false;
+        captureArmedMs = now;
+        if (captureStream)
+            publishCaptureStatus_("recording", s.getName());
+        return;
+    }
+
+    switch (capture.state())
+    {
+    case WaveformCapture::State::Armed:
+    case WaveformCapture::State::Recording:
+        if (now - captureArmedMs >= CAPTURE_TIMEOUT_MS)
+        {
+            capture.cancel();
+            endCaptureSlot_();
+            if (captureStream)
+                publishCaptureStatus_("error", "timeout");
+            captureCh = -1;
+        }
+        return;
+
+    case WaveformCapture::State::Ready:
+    {
+        if (!captureAnalyzed)
+        {
+            endCaptureSlot_();
+            analyzeCapture_();
+            captureAnalyzed = true;
+            if (!captureStream)
+            {
+                capture.cancel(); // analysis-only: nothing to stream
+                captureCh = -1;
+                return;
+            }
+            captureArmedMs = now; // streaming starts now
+        }
+        uint8_t out[CAPTURE_CHUNK_MAX];
+        for (uint8_t i = 0; i < CAPTURE_CHUNKS_PER_TICK; ++i)
+        {
+            const size_t len = capture.peekChunk(out);
+            if (!len)
+                break;
+            // Chunks are events (never merged): a full outbox or a dropped link
+            // must not skip one, so the sequence only moves on a queued send
+            if (!mqtt->publish(state[captureCh].topicCapture, out, len, false))
+                break;
+            capture.commitChunk();
+            captureArmedMs = now; // progress: the timeout now guards a stalled stream
+        }
+        if (now - captureArmedMs >= CAPTURE_TIMEOUT_MS)
+        {
+            capture.cancel();
+            publishCaptureStatus_("error", "stalled");
+            captureCh = -1;
+        }
+        return;
+    }
+
+    case WaveformCapture::State::Idle:
+    default:
+        // All chunks out
+        publishCaptureStatus_("done", CURRENT_CHANNELS[captureCh].name);
+        captureCh = -1;
+        return;
+    }
+}
+
+uint32_t CurrentSensorManager::captureSamples_(size_t ch, uint8_t cycles) const
+{
+    if (!mainsFreqHz)
+        return 0;
+    const uint16_t sps = chips[CURRENT_CHANNELS[ch].chip].samplesPerSecond();
+    return (uint32_t(cycles) * sps + mainsFreqHz / 2) / mainsFreqHz;
+}
+
+void CurrentSensorManager::scheduleHarmonics_(unsigned long now)
+{
+    if (!harmonicsIntervalMs || now - lastHarmonicsMs < harmonicsIntervalMs)
+        return;
+    lastHarmonicsMs = now;
+
+    // Next powered, streaming channel after the last one analysed
+    for (size_t k = 0; k < CURRENT_CHANNEL_COUNT; ++k)
+    {
+        const size_t ch = (harmonicsNext + k) % CURRENT_CHANNEL_COUNT;
+        if (!sensors[ch].isStreaming() || !isGateOn_(ch))
+            continue;
+        harmonicsNext = (ch + 1) % CURRENT_CHANNEL_COUNT;
+        captureQueue = uint8_t(1u << ch);
+        captureCycles = harmonicsCycles;
+        captureStream = false;
+        return;
+    }
+}
+
+void CurrentSensorManager::analyzeCapture_()
+{
+    if (!isGateOn_(captureCh))
+        return; // an OFF lamp has no harmonics worth reporting
+
+    HarmonicAnalyzer::Result r;
+    const uint32_t t0 = micros();
+    const bool ok = harmonics.analyze(capture.data(), capture.size(), capture.spanUs(),
+                                      mainsFreqHz, capture.ampsPerCount(), r);
+    const uint32_t us = micros() - t0;
+    if (!ok)
+        return;
+
+    if (!harmonicsLogged)
+    {
+        Serial.printf("[Current] harmonics: %u samples in %u us (%s)\n",
+                      r.samples, (unsigned)us, HarmonicAnalyzer::vectorized() ? "esp-dsp" : "scalar");
+        harmonicsLogged = true;
+    }
+
+    char buf[112];
+    snprintf(buf, sizeof(buf), "{\"f1\":%.3f,\"h3\":%.4f,\"h5\":%.4f,\"h7\":%.4f,\"thd\":%.1f}",
+             r.fundamentalA, r.h3A, r.h5A, r.h7A, r.thdPct);
+    mqtt->publish(state[captureCh].topicHarmonics, buf, true);
+}
+
+void CurrentSensorManager::endCaptureSlot_()
+{
+    if (captureCh < 0)
+        return;
+    const uint8_t c = CURRENT_CHANNELS[captureCh].chip;
+    sensors[captureCh].setCaptureTap(nullptr);
+    if (chips[c].getSamplesPerPair() != chipSlot[c])
+        chips[c].setSamplesPerPair(chipSlot[c]);
+}
+
+void CurrentSensorManager::publishCaptureStatus_(const char *stateStr, const char *detail)
+{
+    char buf[40];
+    snprintf(buf, sizeof(buf), "%s:%s", stateStr, detail);
+    mqtt->publish(TOPIC_CURRENT_CAPTURE_STATUS, buf, false);
+}
+
+void CurrentSensorManager::baselineKey_(size_t ch, char *key, size_t len)
+{
+    // Keyed by physical input so reordering the table keeps each offset
+    snprintf(key, len, "z%u%u", (unsigned)CURRENT_CHANNELS[ch].chip, (unsigned)CURRENT_CHANNELS[ch].pair);
 }
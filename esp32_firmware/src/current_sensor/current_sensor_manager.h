@@ -2,61 +2,195 @@
 #define CURRENT_SENSOR_MANAGER_H
 
 #include <Arduino.h>
+#include <utility>
 #include "ads1115/ads1115_driver.h"
 #include "current_sensor/zmct103c_sensor.h"
+#include "current_sensor/current_channels.h"
+#include "current_sensor/waveform_capture.h"
+#include "current_sensor/harmonic_analyzer.h"
 
 
 // Lightweight forward declares
-class PubSubClient;
+class TelemetryPublisher;
 class LightManager;
 class FeederManager;
 
+// Registry of CT channels built from CURRENT_CHANNELS (current_channels.h).
+// Channels are published round-robin, one per slot of publishInterval / N, so
+// adding channels spreads the sampling cost instead of stacking it in one tick.
 class CurrentSensorManager
 {
 public:
-    explicit CurrentSensorManager(uint8_t adsAddr = 0x48);
+    CurrentSensorManager();
 
     // Wire services + configure
-    void begin(PubSubClient &mqttClient,
+    void begin(TelemetryPublisher &telemetry,
                LightManager &lights,
                FeederManager &feeder,
-               unsigned long publishIntervalMs = 4000,
-               float burdenHeat = 0.5f,
-               float burdenUV = 0.5f,
-               float thHeatA = 0.20f,
-               float thUvA = 0.05f);
+               unsigned long publishIntervalMs = 4000);
 
     // Non-blocking loop (call from your main loop)
     void readAndPublish();
 
-    // Force an immediate read & publish, ignoring the interval
+    // Producer side: move ready ADS1115 conversions into the sample rings.
+    // Runs on the sampling task once setAcquisitionTask() is called; otherwise
+    // readAndPublish() does it inline.
+    void acquire();
+    void setAcquisitionTask(TaskHandle_t task);
+    // RDY edges not read in time + samples dropped on a full ring, all chips
+    uint32_t getAdsOverruns() const;
+
+    // Force an immediate read & publish of every channel, ignoring the interval
     void publishNow();
 
     // Optional tuning
     void setEnabled(bool en) { enabled = en; }
+
+    // Call before begin(): stream conversions on every chip whose ALERT/RDY pin is
+    // wired (ADS_ALERT_PINS) instead of blocking single-shot reads on every publish.
+    // Each mux slot is one whole-mains-cycle RMS window at the chosen data rate.
+    void setContinuousMode(uint16_t dataRate = RATE_ADS1115_475SPS,
+                           uint8_t mainsHz = 60)
+    {
+        continuousRequested = true;
+        adsDataRate = dataRate;
+        mainsFreqHz = mainsHz;
+    }
+    // Call before begin(): chips with an ALERT pin that are not streaming run the
+    // ADS1115 window comparator on one powered channel instead. A lamp that stops
+    // drawing is reported as FLT within a few mains cycles, without polling.
+    // The comparator watches one pair per chip (first powered row in the table);
+    // the other pair keeps the polled OK/FLT check.
+    void setFaultWatch(bool en, uint16_t dataRate = RATE_ADS1115_860SPS)
+    {
+        faultWatchRequested = en;
+        faultWatchRate = dataRate;
+    }
+
+    // Online zero tracking: once a channel's output has been OFF for quietMs its
+    // windows feed the baseline (no blocking re-zero). On by default.
     void setAutoZeroOnLightsOff(bool en, uint32_t quietMs = 2000)
     {
         autoZero = en;
         autoZeroQuietMs = quietMs;
     }
-    void setThresholds(float heatA, float uvA)
+    void setThresholdA(size_t ch, float a)
     {
-        heat.setThresholdA(heatA);
-        uv.setThresholdA(uvA);
+        if (ch < CURRENT_CHANNEL_COUNT)
+            sensors[ch].setThresholdA(a);
+    }
+
+    // Lamp replaced: relearn the healthy reference for drift detection
+    void resetDriftReference(size_t ch);
+
+    // Energy / lamp-hours. Totals live in RAM and are committed to NVS at most
+    // every persistMinutes (power loss costs at most that much accounting).
+    void setMainsVolts(float v) { mainsVolts = v; }
+    void setEnergyPersistMinutes(uint16_t minutes) { energyPersistMs = uint32_t(minutes) * 60000UL; }
+    void resetOnTime(size_t ch); // new bulb: restart its lamp-hours (saved now)
+    double energyWh(size_t ch) const { return ch < CURRENT_CHANNEL_COUNT ? state[ch].energy.wh : 0.0; }
+    uint32_t onSeconds(size_t ch) const { return ch < CURRENT_CHANNEL_COUNT ? state[ch].energy.onSec : 0; }
+
+    // Waveform capture: record `cycles` mains cycles of raw samples per channel
+    // (ch = CAPTURE_ALL for every streaming channel, one after another) and
+    // publish them as binary chunks on <topic>/capture. Returns false while a
+    // capture is still running or when no channel can stream.
+    static constexpr int CAPTURE_ALL = -1;
+    bool requestCapture(int ch, uint8_t cycles = CAPTURE_DEFAULT_CYCLES);
+    int findChannel(const char *name) const; // case-insensitive; -1 if unknown
+
+    // Harmonics (fundamental, 3rd/5th/7th, THD) on <topic>/harmonics: every
+    // capture is analysed, and every intervalMs one powered channel (round-robin)
+    // gets an analysis-only capture of `cycles` mains cycles. 0 = captures only.
+    void setHarmonicsInterval(uint32_t intervalMs, uint8_t cycles = CAPTURE_DEFAULT_CYCLES)
+    {
+        harmonicsIntervalMs = intervalMs;
+        harmonicsCycles = cycles ? cycles : CAPTURE_DEFAULT_CYCLES;
     }
 
     // Read last values
-    float lastHeatA() const { return lastHeat; }
-    float lastUvA() const { return lastUv; }
+    size_t channelCount() const { return CURRENT_CHANNEL_COUNT; }
+    float lastA(size_t ch) const { return ch < CURRENT_CHANNEL_COUNT ? state[ch].lastA : 0.0f; }
+    float thresholdA(size_t ch) const { return ch < CURRENT_CHANNEL_COUNT ? sensors[ch].getThresholdA() : 0.0f; }
+    DriftDetector::Health health(size_t ch) const
+    {
+        return ch < CURRENT_CHANNEL_COUNT ? sensors[ch].getHealth() : DriftDetector::Health::Learning;
+    }
+    bool isPowered(size_t ch) const { return ch < CURRENT_CHANNEL_COUNT && isGateOn_(ch); }
 
 private:
+    static constexpr size_t TOPIC_LEN = 64;
+
+    // Comparator fault watch: missing edges for this many mains cycles = FLT;
+    // ignored for a while after turn-on (fluorescent strike, heat lamp inrush)
+    static constexpr uint8_t FAULT_WATCH_CYCLES = 3;
+    static constexpr uint32_t FAULT_WATCH_SETTLE_MS = 2000;
+
+    static constexpr uint8_t CAPTURE_DEFAULT_CYCLES = 6;
+    static constexpr uint32_t CAPTURE_TIMEOUT_MS = 3000;
+    static constexpr uint8_t CAPTURE_CHUNKS_PER_TICK = 4; // keeps loop() latency flat
+
+    // Learned offsets go to NVS at most this often, and only when they moved
+    static constexpr uint32_t BASELINE_PERSIST_MS = 30UL * 60UL * 1000UL;
+    static constexpr float BASELINE_PERSIST_MIN_CONF = 0.9f;
+    static constexpr float BASELINE_PERSIST_MIN_DELTA = 0.25f; // counts
+    static constexpr float BASELINE_WARM_BOOT_CONF = 0.5f;     // until re-confirmed
+
+    // Persisted per channel as one NVS blob
+    struct EnergyTotals
+    {
+        double wh = 0.0;    // apparent * PF; double so 1 ms steps still add up
+        uint32_t onSec = 0; // seconds with current above threshold
+    };
+
+    // Per-channel runtime state (derived topics are built once in begin())
+    struct ChannelState
+    {
+        float lastA = 0.0f;
+        bool offAnnounced = false;
+        bool wasOn = false;
+        uint32_t offSinceMs = 0;
+        float savedOffset = NAN; // last value written to NVS
+        bool refSaved = false;   // learned drift reference is in NVS
+        EnergyTotals energy;
+        uint32_t onMsFrac = 0;   // sub-second on-time carry
+        bool energyDirty = false;
+        char topicStatus[TOPIC_LEN] = {0};
+        char topicHealth[TOPIC_LEN] = {0};
+        char topicBaseline[TOPIC_LEN] = {0};
+        char topicPeak[TOPIC_LEN] = {0};
+        char topicCrest[TOPIC_LEN] = {0};
+        char topicEnergy[TOPIC_LEN] = {0};
+        char topicOnTime[TOPIC_LEN] = {0};
+        char topicCapture[TOPIC_LEN] = {0};
+        char topicHarmonics[TOPIC_LEN] = {0};
+    };
+
+    // Expands the tables into the chip/sensor arrays (no heap, no default ctors)
+    template <size_t... C, size_t... I>
+    CurrentSensorManager(std::index_sequence<C...>, std::index_sequence<I...>);
+
     // Owned hardware/sensors (no heap)
-    Ads1115Driver ads;
-    Zmct103cSensor heat;
-    Zmct103cSensor uv;
+    Ads1115Driver chips[ADS_MAX_CHIPS];
+    Zmct103cSensor sensors[CURRENT_CHANNEL_COUNT];
+    ChannelState state[CURRENT_CHANNEL_COUNT];
+    bool chipReady[ADS_MAX_CHIPS] = {false};
+    uint16_t chipSlot[ADS_MAX_CHIPS] = {0}; // normal samples per mux slot
+
+    // Per-chip comparator watch (setFaultWatch)
+    struct FaultWatch
+    {
+        int8_t ch = -1; // channel the window is programmed for
+        bool gateOn = false;
+        bool settled = false; // deadline re-armed after the turn-on settle time
+        unsigned long sinceMs = 0;
+        int16_t lo = 0;
+        int16_t hi = 0;
+    };
+    FaultWatch watch[ADS_MAX_CHIPS];
 
     // Cross-services (wired in begin)
-    PubSubClient *mqtt = nullptr;
+    TelemetryPublisher *mqtt = nullptr;
     LightManager *lights = nullptr;
     FeederManager *feeder = nullptr;
 
@@ -64,27 +198,68 @@ private:
     bool enabled = true;
     bool ready = false;
     unsigned long intervalMs = 4000;
-    unsigned long lastRunMs = 0;
+    unsigned long lastSlotMs = 0;
+    size_t nextChannel = 0;
+    unsigned long lastPersistMs = 0;
 
-    // Auto-zero after lights OFF for a quiet period
-    bool autoZero = false;
-    uint32_t autoZeroQuietMs = 2000;
-    bool wasLightsOn = false;
-    uint32_t lightsOffSinceMs = 0;
+    // Energy accounting
+    float mainsVolts = MAINS_VOLTS;
+    uint32_t energyPersistMs = 10UL * 60UL * 1000UL;
+    unsigned long lastEnergyMs = 0;
+    unsigned long lastEnergyPersistMs = 0;
+
+    // Continuous (ALERT/RDY) sampling
+    bool continuousRequested = false;
+    uint16_t adsDataRate = RATE_ADS1115_475SPS;
+    uint8_t mainsFreqHz = 60;
+    bool externalAcquire = false;
+    bool faultWatchRequested = false;
+    uint16_t faultWatchRate = RATE_ADS1115_860SPS;
 
-    // Last readings
-    float lastHeat = 0.0f;
-    float lastUv = 0.0f;
+    // Waveform capture (one channel at a time)
+    WaveformCapture capture;
+    uint8_t captureQueue = 0; // bit per channel still to record
+    uint8_t captureCycles = CAPTURE_DEFAULT_CYCLES;
+    int8_t captureCh = -1;    // channel being recorded / streamed
+    bool captureStream = true; // false: analysis-only, no chunks
+    bool captureAnalyzed = false;
+    unsigned long captureArmedMs = 0; // armed at, then last chunk queued at
 
-    // soft mute when lights are off
+    // Periodic harmonic analysis
+    HarmonicAnalyzer harmonics;
+    uint32_t harmonicsIntervalMs = 60000;
+    uint8_t harmonicsCycles = CAPTURE_DEFAULT_CYCLES;
+    unsigned long lastHarmonicsMs = 0;
+    size_t harmonicsNext = 0;
+    bool harmonicsLogged = false;
 
-    bool muteLightsOff = true;
-    bool offAnnounced = false;
+    // Zero tracking after a channel's gate is OFF for a quiet period
+    bool autoZero = true;
+    uint32_t autoZeroQuietMs = 2000;
 
     // Internals
-    void sampleAndPublish_(Zmct103cSensor &s, float &lastA,
-                           const char *topicCur, const char *topicStat);
-    void trackLightsForAutoZero_(unsigned long now);
+    bool isGateOn_(size_t ch) const;
+    void sampleAndPublish_(size_t ch);
+    void announceOff_(size_t ch);
+    void trackGatesForAutoZero_(unsigned long now);
+    void publishBaseline_(size_t ch);
+    void publishHealthChanges_();
+    void accumulateEnergy_(unsigned long now);
+    void publishEnergy_(size_t ch);
+    void persistEnergy_(bool force);
+    void loadBaselines_();
+    void persistIfDue_(unsigned long now);
+    static void baselineKey_(size_t ch, char *key, size_t len);
+    void pollStreams_();
+    void beginFaultWatch_(uint8_t chip);
+    void serviceFaultWatch_(unsigned long now);
+    void faultWindow_(size_t ch, int16_t &lo, int16_t &hi) const;
+    void serviceCapture_(unsigned long now);
+    uint32_t captureSamples_(size_t ch, uint8_t cycles) const; // whole cycles at the chip's rate
+    void endCaptureSlot_();
+    void scheduleHarmonics_(unsigned long now);
+    void analyzeCapture_();
+    void publishCaptureStatus_(const char *state, const char *detail);
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,107 @@
+#include "current_sensor/drift_detector.h"
+#include <math.h>
+
+void DriftDetector::startRun()
+{
+    settleLeft = cfg.settleWindows;
+    if (state == Health::Fail)
+        state = isLearned() ? Health::Ok : Health::Learning;
+}
+
+DriftDetector::Health DriftDetector::update(float x)
+{
+    if (settleLeft)
+    {
+        --settleLeft;
+        return state;
+    }
+
+    // Learning: Welford, nothing to compare against yet
+    if (!isLearned())
+    {
+        ++ref.n;
+        const float d = x - ref.mean;
+        ref.mean += d / ref.n;
+        ref.m2 += d * (x - ref.mean);
+        state = Health::Learning;
+        return state;
+    }
+
+    // Abrupt drop: one window is enough
+    if (x < cfg.failFraction * ref.mean)
+    {
+        state = Health::Fail;
+        return state;
+    }
+
+    // Slow drift: lower CUSUM (σ units) + EWMA sag
+    const float sigma = sigmaA();
+    const float z = (ref.mean - x) / sigma;
+    cusumLo = cusumLo + z - cfg.cusumK;
+    if (cusumLo < 0.0f)
+        cusumLo = 0.0f;
+
+    if (!ewmaInit)
+    {
+        ewma = x;
+        ewmaInit = true;
+    }
+    else
+    {
+        ewma += cfg.ewmaLambda * (x - ewma);
+    }
+
+    const bool cusumHit = cusumLo > cfg.cusumH;
+    const bool ewmaHit = ewma < (1.0f - cfg.ewmaDropFraction) * ref.mean;
+
+    if (cusumHit || ewmaHit)
+    {
+        state = Health::Degrading;
+    }
+    else if (state != Health::Degrading || cusumLo < 0.5f * cfg.cusumH)
+    {
+        // Degrading clears with hysteresis (CUSUM back under half the interval)
+        state = Health::Ok;
+    }
+    return state;
+}
+
+void DriftDetector::resetReference()
+{
+    ref = Reference();
+    state = Health::Learning;
+    cusumLo = 0.0f;
+    ewmaInit = false;
+}
+
+void DriftDetector::restoreReference(const Reference &r)
+{
+    ref = r;
+    cusumLo = 0.0f;
+    ewmaInit = false;
+    state = isLearned() ? Health::Ok : Health::Learning;
+}
+
+float DriftDetector::sigmaA() const
+{
+    const float var = ref.n > 1 ? ref.m2 / (ref.n - 1) : 0.0f;
+    const float sd = var > 0.0f ? sqrtf(var) : 0.0f;
+    const float floorSd = cfg.minSigmaFraction * fabsf(ref.mean);
+    return sd > floorSd ? sd : (floorSd > 1e-6f ? floorSd : 1e-6f);
+}
+
+const char *DriftDetector::toString(Health h)
+{
+    switch (h)
+    {
+    case Health::Ok:
+        return "OK";
+    case Health::Degrading:
+        return "DEGRADING";
+    case Health::Fail:
+        return "FAIL";
+    case Health::Learning:
+    default:
+        return "LEARNING";
+    }
+}
@@ -0,0 +1,79 @@
+#ifndef DRIFT_DETECTOR_H
+#define DRIFT_DETECTOR_H
+
+#include <stdint.h>
+
+// Streaming change-point detection on a lamp's per-window RMS current.
+// O(1) state per channel, host-buildable (no Arduino deps).
+//
+//  - Welford mean/variance learns the lamp's healthy reference once, then freezes
+//    it (persist it so slow drift across days/weeks stays visible).
+//  - FAIL: a single window below failFraction × reference (abrupt drop).
+//  - DEGRADING: lower-sided CUSUM in σ units, or an EWMA that sags more than
+//    ewmaDropFraction below the reference (slow drift).
+class DriftDetector
+{
+public:
+    enum class Health : uint8_t
+    {
+        Learning,
+        Ok,
+        Degrading,
+        Fail
+    };
+
+    struct Config
+    {
+        uint16_t learnWindows = 300;     // windows that define "healthy"
+        uint16_t settleWindows = 50;     // ignored after each turn-on (inrush / warm-up)
+        float failFraction = 0.5f;       // window < 50 % of reference → FAIL
+        float cusumK = 1.0f;             // slack, σ units
+        float cusumH = 20.0f;            // decision interval, σ units
+        float ewmaLambda = 0.02f;        // ~50-window memory
+        float ewmaDropFraction = 0.08f;  // EWMA 8 % under reference → DEGRADING
+        float minSigmaFraction = 0.02f;  // σ floor: mains voltage wander (~2 %)
+    };
+
+    // Learned reference (what gets persisted)
+    struct Reference
+    {
+        float mean = 0.0f;
+        float m2 = 0.0f; // Σ (x - mean)²
+        uint32_t n = 0;
+    };
+
+    DriftDetector() = default;
+    explicit DriftDetector(const Config &c) : cfg(c) {}
+
+    // Output just turned on: skip the settle windows, keep reference + CUSUM
+    void startRun();
+
+    // Feed one whole-cycle RMS value (amps); returns the health after it
+    Health update(float rmsA);
+
+    // Forget everything (e.g. bulb replaced)
+    void resetReference();
+    void restoreReference(const Reference &r);
+    const Reference &reference() const { return ref; }
+    bool isLearned() const { return ref.n >= cfg.learnWindows; }
+
+    Health health() const { return state; }
+    float referenceA() const { return ref.mean; }
+    float sigmaA() const;
+    float cusum() const { return cusumLo; }
+    float ewmaA() const { return ewma; }
+
+    static const char *toString(Health h);
+
+private:
+    Config cfg;
+    Reference ref;
+    Health state = Health::Learning;
+
+    uint16_t settleLeft = 0;
+    float cusumLo = 0.0f;
+    float ewma = 0.0f;
+    bool ewmaInit = false;
+};
+
+#endif // DRIFT_DETECTOR_H
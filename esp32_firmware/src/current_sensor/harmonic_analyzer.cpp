@@ -0,0 +1,111 @@
+#include "current_sensor/harmonic_analyzer.h"
+#include <math.h>
+
+// esp-dsp ships with the S3 Arduino core; HARMONICS_SCALAR=1 forces the plain loop
+#if !defined(HARMONICS_SCALAR) && defined(__has_include)
+#if __has_include(<dsps_dotprod.h>)
+#include <dsps_dotprod.h>
+#define HARMONICS_ESP_DSP 1
+#endif
+#endif
+
+static constexpr uint8_t HARMONIC_ORDERS[HarmonicAnalyzer::HARMONICS] = {1, 3, 5, 7};
+static constexpr float TWO_PI_F = 6.28318531f;
+
+bool HarmonicAnalyzer::vectorized()
+{
+#ifdef HARMONICS_ESP_DSP
+    return true;
+#else
+    return false;
+#endif
+}
+
+float HarmonicAnalyzer::dot_(const float *a, const float *b, uint16_t n)
+{
+#ifdef HARMONICS_ESP_DSP
+    float r = 0.0f;
+    dsps_dotprod_f32(a, b, &r, n);
+    return r;
+#else
+    float r = 0.0f;
+    for (uint16_t i = 0; i < n; ++i)
+        r += a[i] * b[i];
+    return r;
+#endif
+}
+
+void HarmonicAnalyzer::buildTables_(uint16_t n, float cyclesPerSample)
+{
+    winSum = 0.0f;
+    for (uint16_t i = 0; i < n; ++i)
+    {
+        win[i] = 0.5f - 0.5f * cosf(TWO_PI_F * i / (n - 1));
+        winSum += win[i];
+    }
+    for (uint8_t h = 0; h < HARMONICS; ++h)
+    {
+        const float w = TWO_PI_F * HARMONIC_ORDERS[h] * cyclesPerSample;
+        for (uint16_t i = 0; i < n; ++i)
+        {
+            cosT[h][i] = cosf(w * i);
+            sinT[h][i] = sinf(w * i);
+        }
+    }
+    tableN = n;
+    tableCps = cyclesPerSample;
+}
+
+bool HarmonicAnalyzer::analyze(const int16_t *samples, uint16_t n, uint32_t spanUs,
+                               uint8_t mainsHz, float ampsPerCount, Result &out)
+{
+    out = Result();
+    if (n > MAX_SAMPLES)
+    {
+        spanUs = uint32_t(uint64_t(spanUs) * (MAX_SAMPLES - 1) / (n - 1));
+        n = MAX_SAMPLES;
+    }
+    if (!samples || n < 16 || spanUs == 0 || mainsHz == 0)
+        return false;
+
+    const float sampleHz = (n - 1) * 1e6f / spanUs;
+    const float cyclesPerSample = float(mainsHz) / sampleHz;
+
+    // Tables only change with the length or a clock drift above ~0.1%
+    if (n != tableN || fabsf(cyclesPerSample - tableCps) > tableCps * 1e-3f)
+        buildTables_(n, cyclesPerSample);
+
+    int32_t sum = 0;
+    for (uint16_t i = 0; i < n; ++i)
+        sum += samples[i];
+    const float mean = float(sum) / n;
+    for (uint16_t i = 0; i < n; ++i)
+        x[i] = (samples[i] - mean) * win[i];
+
+    // Windowed single-bin DFT: peak = 2|X| / Σw, RMS = peak / √2
+    const float scale = 1.41421356f / winSum * ampsPerCount;
+    float rmsA[HARMONICS];
+    for (uint8_t h = 0; h < HARMONICS; ++h)
+    {
+        if (HARMONIC_ORDERS[h] * cyclesPerSample >= 0.5f)
+        {
+            rmsA[h] = 0.0f; // above Nyquist at this rate
+            continue;
+        }
+        const float re = dot_(x, cosT[h], n);
+        const float im = dot_(x, sinT[h], n);
+        rmsA[h] = sqrtf(re * re + im * im) * scale;
+    }
+
+    out.fundamentalA = rmsA[0];
+    out.h3A = rmsA[1];
+    out.h5A = rmsA[2];
+    out.h7A = rmsA[3];
+    out.thdPct = rmsA[0] > 0.0f
+                     ? 100.0f * sqrtf(rmsA[1] * rmsA[1] + rmsA[2] * rmsA[2] + rmsA[3] * rmsA[3]) / rmsA[0]
+                     : 0.0f;
+    out.sampleHz = sampleHz;
+    out.samples = n;
+    out.valid = true;
+    return true;
+}
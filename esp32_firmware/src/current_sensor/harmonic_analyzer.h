@@ -0,0 +1,56 @@
+#ifndef HARMONIC_ANALYZER_H
+#define HARMONIC_ANALYZER_H
+
+#include <stdint.h>
+
+// Odd-harmonic content of a CT waveform (fundamental, 3rd, 5th, 7th, THD).
+// Pure (no Arduino deps) so it also builds on the host.
+//
+// Works on one contiguous run of raw counts (a waveform capture). The DC part
+// is removed, a Hann window is applied and each harmonic is a single-bin DFT:
+// two dot products against cos/sin tables built for the measured sample rate
+// (the ADS1115 clock is only ±10%, so the nominal rate would smear the bins).
+// The dot products use esp-dsp's vector kernels on the S3 when available and a
+// plain loop otherwise; both give the same result.
+//
+// THD is truncated to the 7th harmonic: at 860 SPS the 9th of 60 Hz is above
+// Nyquist.
+class HarmonicAnalyzer
+{
+public:
+    struct Result
+    {
+        float fundamentalA = 0.0f; // RMS amps per harmonic
+        float h3A = 0.0f;
+        float h5A = 0.0f;
+        float h7A = 0.0f;
+        float thdPct = 0.0f;    // sqrt(h3² + h5² + h7²) / h1 * 100
+        float sampleHz = 0.0f;  // measured rate used for the tables
+        uint16_t samples = 0;
+        bool valid = false;
+    };
+
+    static constexpr uint16_t MAX_SAMPLES = 256;
+    static constexpr uint8_t HARMONICS = 4; // 1, 3, 5, 7
+
+    // samples: raw counts; spanUs: time from first to last sample
+    bool analyze(const int16_t *samples, uint16_t n, uint32_t spanUs,
+                 uint8_t mainsHz, float ampsPerCount, Result &out);
+
+    // True when the esp-dsp dot product is compiled in
+    static bool vectorized();
+
+private:
+    float x[MAX_SAMPLES];                     // windowed, DC-free signal
+    float win[MAX_SAMPLES];                   // Hann
+    float cosT[HARMONICS][MAX_SAMPLES];
+    float sinT[HARMONICS][MAX_SAMPLES];
+    uint16_t tableN = 0;
+    float tableCps = 0.0f;                    // mains cycles per sample the tables were built for
+    float winSum = 0.0f;
+
+    void buildTables_(uint16_t n, float cyclesPerSample);
+    static float dot_(const float *a, const float *b, uint16_t n);
+};
+
+#endif // HARMONIC_ANALYZER_H
@@ -0,0 +1,79 @@
+#include "current_sensor/rms_engine.h"
+#include <math.h>
+
+void RmsEngine::configure(uint16_t sps, uint8_t mainsHz, uint8_t minCycles)
+{
+    if (sps == 0 || mainsHz == 0)
+        return;
+    if (minCycles == 0)
+        minCycles = 1;
+
+    // Pick the cycle count whose sample length lands closest to an integer
+    uint8_t bestCycles = minCycles;
+    float bestErr = 1.0f;
+    for (uint8_t c = minCycles; c <= MAX_CYCLES; ++c)
+    {
+        const float len = float(sps) * c / mainsHz;
+        if (len > MAX_WINDOW)
+            break;
+        const float err = fabsf(len - roundf(len));
+        if (err < bestErr - 1e-4f)
+        {
+            bestErr = err;
+            bestCycles = c;
+        }
+    }
+
+    cycles = bestCycles;
+    const float len = roundf(float(sps) * cycles / mainsHz);
+    window = len < 2.0f ? 2 : (len > MAX_WINDOW ? MAX_WINDOW : uint16_t(len));
+    reset();
+}
+
+void RmsEngine::setOffsetCounts(float counts)
+{
+    offsetQ8 = int32_t(lroundf(counts * 256.0f));
+    reset();
+}
+
+bool RmsEngine::addSample(int16_t raw)
+{
+    const int32_t d = (int32_t(raw) << 8) - offsetQ8;
+    sum += d;
+    sumSq += int64_t(d) * d;
+    const int32_t a = d < 0 ? -d : d;
+    if (a > peak)
+        peak = a;
+
+    if (++n < window)
+        return false;
+
+    close_();
+    return true;
+}
+
+void RmsEngine::reset()
+{
+    n = 0;
+    sum = 0;
+    sumSq = 0;
+    peak = 0;
+}
+
+void RmsEngine::close_()
+{
+    // var = E[d²] - E[d]²; evaluated once per window, so float is fine here
+    const double mean = double(sum) / n;
+    double var = double(sumSq) / n - mean * mean;
+    if (var < 0.0)
+        var = 0.0;
+
+    result.rmsCounts = float(sqrt(var) / 256.0);
+    result.peakCounts = peak / 256.0f;
+    result.meanCounts = float(mean / 256.0);
+    result.crest = result.rmsCounts > 0.5f ? result.peakCounts / result.rmsCounts : 0.0f;
+    result.samples = n;
+    result.cycles = cycles;
+
+    reset();
+}
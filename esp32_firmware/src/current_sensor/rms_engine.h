@@ -0,0 +1,61 @@
+#ifndef RMS_ENGINE_H
+#define RMS_ENGINE_H
+
+#include <stdint.h>
+
+// Streaming true-RMS over whole mains cycles.
+// Pure integer hot path (no Arduino deps) so it also builds on the host.
+//
+// Samples are taken relative to a sub-LSB offset (Q8 counts) and squared into a
+// 64-bit accumulator. A window closes after a whole number of mains cycles; its
+// mean is removed before the square root, so a slightly stale offset only
+// shifts the reported peak, never the RMS.
+class RmsEngine
+{
+public:
+    struct Result
+    {
+        float rmsCounts = 0.0f;  // AC RMS over the window
+        float peakCounts = 0.0f; // max |raw - offset| in the window
+        float crest = 0.0f;      // peak / rms (0 when rms is ~0)
+        float meanCounts = 0.0f; // window DC relative to the offset
+        uint16_t samples = 0;
+        uint8_t cycles = 0;
+    };
+
+    static constexpr uint8_t MAX_CYCLES = 16;
+    static constexpr uint16_t MAX_WINDOW = 1024; // keeps sumSq well inside int64
+
+    // sps: ADC data rate; window = whole cycles whose length is closest to an
+    // integer sample count (e.g. 860 SPS → 3 cycles = 43, 475 SPS → 12 cycles = 95)
+    void configure(uint16_t sps, uint8_t mainsHz = 60, uint8_t minCycles = 3);
+
+    void setOffsetCounts(float counts);
+    float getOffsetCounts() const { return offsetQ8 / 256.0f; }
+
+    // Feed one raw count; returns true when a window just closed (see last())
+    bool addSample(int16_t raw);
+
+    // Drop the partial window (stream discontinuity, mux switch, offset change)
+    void reset();
+
+    const Result &last() const { return result; }
+    uint16_t windowSamples() const { return window; }
+    uint8_t windowCycles() const { return cycles; }
+
+private:
+    int32_t offsetQ8 = 0; // offset in 1/256 counts
+    uint16_t window = 43;
+    uint8_t cycles = 3;
+
+    uint16_t n = 0;
+    int64_t sum = 0;   // Σ d      (Q8)
+    int64_t sumSq = 0; // Σ d²     (Q16)
+    int32_t peak = 0;  // max |d|  (Q8)
+
+    Result result;
+
+    void close_();
+};
+
+#endif // RMS_ENGINE_H
@@ -0,0 +1,95 @@
+#include "current_sensor/waveform_capture.h"
+
+bool WaveformCapture::begin(uint16_t maxSamples)
+{
+    if (buf)
+        return true; // allocated once for the lifetime of the firmware
+
+    const size_t bytes = size_t(maxSamples) * sizeof(int16_t);
+    if (psramFound())
+    {
+        buf = static_cast<int16_t *>(ps_malloc(bytes));
+        psram = (buf != nullptr);
+    }
+    if (!buf)
+        buf = static_cast<int16_t *>(malloc(bytes));
+    cap = buf ? maxSamples : 0;
+    return buf != nullptr;
+}
+
+bool WaveformCapture::arm(uint8_t channel, uint16_t samples, uint16_t sps, float ampsPerCount, float offsetCounts,
+                          bool startAnywhere)
+{
+    if (!buf || samples == 0)
+        return false;
+
+    target = samples > cap ? cap : samples;
+    count = 0;
+    nextSeq = 0;
+    anyStart = startAnywhere;
+
+    hdr.channel = channel;
+    hdr.captureId++;
+    hdr.totalSamples = target;
+    hdr.chunkCount = uint16_t((target + CAPTURE_SAMPLES_PER_CHUNK - 1) / CAPTURE_SAMPLES_PER_CHUNK);
+    hdr.sps = sps;
+    hdr.ampsPerCount = ampsPerCount;
+    hdr.offsetCounts = offsetCounts;
+
+    st = State::Armed;
+    return true;
+}
+
+void WaveformCapture::feed(const AdsSample &s)
+{
+    if (st != State::Armed && st != State::Recording)
+        return;
+
+    if (s.flags & SAMPLE_GAP)
+    {
+        // New contiguous run: start (or restart) the capture here
+        st = State::Recording;
+        count = 0;
+    }
+    else if (st == State::Armed)
+    {
+        if (!anyStart)
+            return; // mid-slot; wait for a clean start
+        st = State::Recording;
+    }
+
+    if (count == 0)
+        hdr.t0Us = s.tUs;
+    buf[count++] = s.raw;
+    tLastUs = s.tUs;
+
+    if (count >= target)
+    {
+        hdr.spanUs = tLastUs - hdr.t0Us;
+        st = State::Ready;
+    }
+}
+
+size_t WaveformCapture::peekChunk(uint8_t *out)
+{
+    if (st != State::Ready)
+        return 0;
+    if (nextSeq >= hdr.chunkCount)
+    {
+        st = State::Idle;
+        return 0;
+    }
+
+    const uint16_t first = uint16_t(nextSeq * CAPTURE_SAMPLES_PER_CHUNK);
+    const uint16_t left = uint16_t(target - first);
+    hdr.seq = nextSeq;
+    hdr.firstIndex = first;
+    hdr.sampleCount = left < CAPTURE_SAMPLES_PER_CHUNK ? left : CAPTURE_SAMPLES_PER_CHUNK;
+    return captureEncodeChunk(hdr, buf + first, out);
+}
+
+void WaveformCapture::commitChunk()
+{
+    if (st == State::Ready && nextSeq < hdr.chunkCount)
+        ++nextSeq;
+}
@@ -0,0 +1,73 @@
+#ifndef WAVEFORM_CAPTURE_H
+#define WAVEFORM_CAPTURE_H
+
+#include <Arduino.h>
+#include "ads1115/ads1115_driver.h"
+#include "capture_frame.h"
+
+// On-demand raw waveform capture for one CT channel at a time.
+// The buffer is allocated once in begin() (PSRAM when the board has it) and
+// filled from the consumer side: the channel's sensor forwards every sample it
+// drains via feed(), so capturing adds no bus traffic and never blocks.
+// A capture only keeps an evenly spaced run: it starts on a SAMPLE_GAP (slot
+// start) and restarts if another discontinuity arrives before it is full.
+class WaveformCapture
+{
+public:
+    enum class State : uint8_t
+    {
+        Idle,
+        Armed,     // waiting for the start of a contiguous run
+        Recording, // filling the buffer
+        Ready      // full; hand out chunks with peekChunk()/commitChunk()
+    };
+
+    static constexpr uint16_t MAX_SAMPLES = 1024;
+
+    bool begin(uint16_t maxSamples = MAX_SAMPLES);
+    bool inPsram() const { return psram; }
+    uint16_t capacity() const { return cap; }
+
+    // Start a new capture of `samples` (clamped to capacity) for a channel.
+    // sps / ampsPerCount / offsetCounts are copied into every chunk header.
+    // startAnywhere: the pair streams without mux slots, so any sample may
+    // begin the run (otherwise wait for the next slot start).
+    bool arm(uint8_t channel, uint16_t samples, uint16_t sps, float ampsPerCount, float offsetCounts,
+             bool startAnywhere = false);
+    void cancel() { st = State::Idle; }
+
+    // Consumer-side tap (called from Zmct103cSensor::poll())
+    void feed(const AdsSample &s);
+
+    // Encode the next chunk into out (CAPTURE_CHUNK_MAX bytes) without
+    // consuming it. Returns its length, or 0 once every chunk has been
+    // committed (state → Idle). commitChunk() after the chunk was sent; a
+    // failed send just peeks the same chunk again later.
+    size_t peekChunk(uint8_t *out);
+    void commitChunk();
+
+    State state() const { return st; }
+    uint8_t channel() const { return hdr.channel; }
+    uint16_t captureId() const { return hdr.captureId; }
+
+    // The recorded run (valid once Ready)
+    const int16_t *data() const { return buf; }
+    uint16_t size() const { return st == State::Ready ? target : 0; }
+    uint32_t spanUs() const { return hdr.spanUs; }
+    float ampsPerCount() const { return hdr.ampsPerCount; }
+
+private:
+    int16_t *buf = nullptr;
+    uint16_t cap = 0;
+    bool psram = false;
+
+    State st = State::Idle;
+    bool anyStart = false;
+    uint16_t target = 0;
+    uint16_t count = 0;
+    uint32_t tLastUs = 0;
+    uint16_t nextSeq = 0;
+    CaptureChunkHeader hdr;
+};
+
+#endif // WAVEFORM_CAPTURE_H
@@ -6,12 +6,18 @@ Zmct103cSensor::Zmct103cSensor(Ads1115Driver &ads,
                                uint8_t pair,
                                const char *name,
                                float burdenOhms,
-                               float thresholdA)
+                               float thresholdA,
+                               adsGain_t gain)
     : ads(ads), pair(pair), name(name),
-      burdenOhms(burdenOhms), thresholdA(thresholdA)
+      burdenOhms(burdenOhms), thresholdA(thresholdA), gain(gain),
+      ampsPerCount(adsAmpsPerCount(gain, burdenOhms))
 {
-    // Ensure intended gain for CT + burden (±0.512 V recommended here)
-    ads.setGain(GAIN_EIGHT);
+}
+
+void Zmct103cSensor::setBurdenOhms(float ohms)
+{
+    burdenOhms = ohms;
+    ampsPerCount = adsAmpsPerCount(gain, ohms);
 }
 
 void Zmct103cSensor::calibrateOffset(uint16_t samples, uint16_t delayMsPerSample)
@@ -22,21 +28,125 @@ void Zmct103cSensor::calibrateOffset(uint16_t samples, uint16_t delayMsPerSample
         sum += readRawOnce_();
         delay(delayMsPerSample);
     }
-    offsetCounts = float(sum) / float(samples);
+    seedOffset(float(sum) / float(samples), 1.0f); // keep the fraction (sub-LSB)
+}
+
+void Zmct103cSensor::seedOffset(float counts, float confidence)
+{
+    baseline.seed(counts, confidence);
+    offsetCounts = counts;
+
+    // Restarts the partial window that used the old offset
+    rms.setOffsetCounts(offsetCounts);
 }
 
 float Zmct103cSensor::readCurrentA(uint16_t samples, uint16_t delayUsPerSample) const
 {
-    long sumAbsDev = 0;
+    if (samples == 0)
+        return 0.0f;
+
+    float sum = 0.0f, sumSq = 0.0f;
     for (uint16_t i = 0; i < samples; ++i)
     {
-        const int16_t raw = readRawOnce_();
-        sumAbsDev += abs(raw - int16_t(offsetCounts));
+        const float d = float(readRawOnce_()) - offsetCounts;
+        sum += d;
+        sumSq += d * d;
         delayMicroseconds(delayUsPerSample);
     }
-    const float avgCounts = float(sumAbsDev) / float(samples);
-    const float volts = avgCounts * ads.lsbVolts(); // across burden
-    return volts / burdenOhms;                      // I = V / R
+    const float mean = sum / samples;
+    const float var = sumSq / samples - mean * mean;
+    const float rmsCounts = var > 0.0f ? sqrtf(var) : 0.0f;
+    return rmsCounts * ampsPerCount; // I = V / R
+}
+
+uint16_t Zmct103cSensor::configureStream(uint8_t mainsHz)
+{
+    rms.configure(ads.samplesPerSecond(), mainsHz);
+    rms.setOffsetCounts(offsetCounts);
+    sumWindowSq = 0.0f;
+    maxPeakCounts = 0.0f;
+    windows = 0;
+    return rms.windowSamples();
+}
+
+void Zmct103cSensor::poll(bool powered)
+{
+    AdsSample buf[16];
+    size_t n;
+    while ((n = ads.drain(pair, buf, sizeof(buf) / sizeof(buf[0]))) > 0)
+    {
+        for (size_t i = 0; i < n; ++i)
+        {
+            if (tap)
+                tap->feed(buf[i]);
+
+            if (buf[i].flags & SAMPLE_GAP)
+                rms.reset(); // only evenly spaced runs make a whole-cycle window
+
+            if (rms.addSample(buf[i].raw))
+            {
+                const RmsEngine::Result &r = rms.last();
+                if (idleNow)
+                {
+                    // Window mean is relative to the offset it was taken with
+                    if (baseline.fold(offsetCounts + r.meanCounts, r.rmsCounts))
+                    {
+                        offsetCounts = baseline.offset();
+                        rms.setOffsetCounts(offsetCounts); // at a window boundary: nothing lost
+                    }
+                    continue;
+                }
+                windowA = r.rmsCounts * ampsPerCount;
+                if (!powered)
+                    continue; // ~0 A by design; would drag the next reading towards FLT
+                updateHealth(windowA); // settle windows after startRun() are skipped inside
+                sumWindowSq += r.rmsCounts * r.rmsCounts;
+                if (r.peakCounts > maxPeakCounts)
+                    maxPeakCounts = r.peakCounts;
+                ++windows;
+            }
+        }
+    }
+}
+
+void Zmct103cSensor::startRun()
+{
+    drift.startRun();
+    // Anything still accumulated predates this turn-on
+    sumWindowSq = 0.0f;
+    maxPeakCounts = 0.0f;
+    windows = 0;
+}
+
+void Zmct103cSensor::updateHealth(float rmsA)
+{
+    const DriftDetector::Health before = drift.health();
+    if (drift.update(rmsA) != before)
+        healthChanged = true;
+}
+
+bool Zmct103cSensor::takeHealthChange()
+{
+    const bool changed = healthChanged;
+    healthChanged = false;
+    return changed;
+}
+
+float Zmct103cSensor::takeCurrentA()
+{
+    poll(true);
+    if (windows == 0)
+        return lastRmsA; // no whole window since the last take
+
+    const float rmsCounts = sqrtf(sumWindowSq / windows);
+    lastRmsA = rmsCounts * ampsPerCount;
+    lastPeakA = maxPeakCounts * ampsPerCount;
+    lastCrest = rmsCounts > 0.5f ? maxPeakCounts / rmsCounts : 0.0f;
+
+    sumWindowSq = 0.0f;
+    maxPeakCounts = 0.0f;
+    windows = 0;
+    return lastRmsA;
 }
 
 void Zmct103cSensor::publishOnce(PubSubClient &mqtt,
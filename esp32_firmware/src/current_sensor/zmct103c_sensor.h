@@ -3,6 +3,10 @@
 
 #include <Arduino.h>
 #include "ads1115/ads1115_driver.h"
+#include "current_sensor/rms_engine.h"
+#include "current_sensor/baseline_tracker.h"
+#include "current_sensor/drift_detector.h"
+#include "current_sensor/waveform_capture.h"
 
 class PubSubClient;
 class LightManager;
@@ -13,19 +17,64 @@ public:
     // pair: 0 => AIN0-AIN1, 1 => AIN2-AIN3
     // burdenOhms defaults to 0.5 Ω like your original code
     // thresholdA is optional; used for OK/FLT when publishing status
+    // gain: this pair's PGA setting. The sensor only uses it for scaling; the
+    // owner programs it on the chip (Ads1115Driver::setPairGain).
     Zmct103cSensor(Ads1115Driver &ads,
                    uint8_t pair,
                    const char *name,
                    float burdenOhms = 0.5f,
-                   float thresholdA = 0.0f);
+                   float thresholdA = 0.0f,
+                   adsGain_t gain = GAIN_EIGHT);
 
-    // Auto-zero with lamps OFF (baseline offset in counts)
+    // Blocking auto-zero with lamps OFF (baseline offset in counts).
+    // Only needed for channels that cannot stream; see setIdle() otherwise.
     void calibrateOffset(uint16_t samples = 100, uint16_t delayMsPerSample = 5);
 
-    // Your original math:
-    // avg(|raw - offset|) * lsbVolts / burden → amps
+    // Online zero tracking (continuous mode): while idle, every closed window's
+    // mean is folded into the baseline and the offset follows it. Idle windows
+    // are not counted towards takeCurrentA().
+    void setIdle(bool idle) { idleNow = idle; }
+    void seedOffset(float counts, float confidence);
+    float getOffsetCounts() const { return offsetCounts; }
+    float getBaselineConfidence() const { return baseline.confidence(); }
+
+    // Blocking fallback (single-shot reads, not cycle-synchronous):
+    // true RMS of (raw - offset) * ampsPerCount → amps
     float readCurrentA(uint16_t samples = 40, uint16_t delayUsPerSample = 500) const;
 
+    // Continuous mode (driver streaming via ALERT/RDY):
+    // configureStream() sizes the RMS window to whole mains cycles at the driver's
+    // data rate and returns its length in samples (use it as samplesPerPair).
+    // poll() feeds buffered samples through the RMS engine (never waits on the bus);
+    // `powered` is the output's gate: only windows closed while it is on reach the
+    // drift detector and the takeCurrentA() average (an OFF window is ~0 A, not
+    // a failing lamp).
+    // takeCurrentA() returns the RMS over the powered windows closed since the
+    // last call, or the previous value if none closed; call it only while the gate is on.
+    uint16_t configureStream(uint8_t mainsHz = 60);
+    void poll(bool powered);
+    float takeCurrentA();
+    bool isStreaming() const { return ads.isContinuous(); }
+    // Forward every drained sample to a waveform capture (nullptr = off)
+    void setCaptureTap(WaveformCapture *cap) { tap = cap; }
+
+    // RMS of the most recent non-idle window (freshest reading for integration)
+    float getWindowA() const { return windowA; }
+
+    // Lamp health (change-point detection on powered windows).
+    // startRun() on each turn-on (also drops windows accumulated before it);
+    // updateHealth() feeds a reading by hand (blocking mode).
+    // takeHealthChange() is true once per transition.
+    void startRun();
+    void updateHealth(float rmsA);
+    bool takeHealthChange();
+    DriftDetector::Health getHealth() const { return drift.health(); }
+    DriftDetector &driftDetector() { return drift; }
+
+    // Window stats from the last takeCurrentA()
+    float getPeakA() const { return lastPeakA; }
+    float getCrestFactor() const { return lastCrest; }
+
     // Convenience (optional) publish
     void publishOnce(PubSubClient &mqtt,
                      const LightManager &lights,
@@ -33,8 +82,10 @@ public:
                      const char *topicStatus) const;
 
     // Tweaks / accessors
-    void setBurdenOhms(float ohms) { burdenOhms = ohms; }
+    void setBurdenOhms(float ohms);
     float getBurdenOhms() const { return burdenOhms; }
+    adsGain_t getGain() const { return gain; }
+    float getAmpsPerCount() const { return ampsPerCount; }
     void setThresholdA(float a) { thresholdA = a; }
     float getThresholdA() const { return thresholdA; }
     const char *getName() const { return name; }
@@ -45,8 +96,25 @@ private:
     const char *name;   // label
     float burdenOhms;
     float thresholdA;
+    adsGain_t gain;
+    float ampsPerCount; // lsbVolts(gain) / burden, folded once
     float offsetCounts = 0.0f;
 
+    // Streaming RMS (continuous mode)
+    RmsEngine rms;
+    BaselineTracker baseline;
+    bool idleNow = false;
+    WaveformCapture *tap = nullptr;
+    DriftDetector drift;
+    bool healthChanged = false;
+    float sumWindowSq = 0.0f; // Σ rms² over windows since last take (counts²)
+    float maxPeakCounts = 0.0f;
+    uint32_t windows = 0;
+    float windowA = 0.0f;
+    float lastRmsA = 0.0f;
+    float lastPeakA = 0.0f;
+    float lastCrest = 0.0f;
+
     int16_t readRawOnce_() const;
 };
 
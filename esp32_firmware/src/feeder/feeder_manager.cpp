@@ -3,7 +3,7 @@
 #include "auto_mode/auto_mode_manager.h"
 #include "topics.h"
 
-void FeederManager::begin(PubSubClient *mqttClient, AutoModeManager *autoModeManager)
+void FeederManager::begin(TelemetryPublisher *mqttClient, AutoModeManager *autoModeManager)
 {
     client = mqttClient;
     autoMode = autoModeManager;
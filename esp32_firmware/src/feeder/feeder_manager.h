@@ -2,7 +2,7 @@
 #define FEEDER_MANAGER_H
 
 #include <Arduino.h>
-#include <PubSubClient.h>
+#include "mqtt/telemetry_publisher.h"
 #include <RTClib.h>
 
 
@@ -11,7 +11,7 @@ class AutoModeManager;
 class FeederManager
 {
 public:
-    void begin(PubSubClient *mqttClient, AutoModeManager *autoMode);
+    void begin(TelemetryPublisher *mqttClient, AutoModeManager *autoMode);
     void update(const DateTime &now);
     void runScheduled();
     void runManual();
@@ -24,7 +24,7 @@ public:
     int getFeedCount() const;
 
 private:
-    PubSubClient *client = nullptr;
+    TelemetryPublisher *client = nullptr;
     AutoModeManager *autoMode = nullptr;
 
     static constexpr int AIN1 = 16;
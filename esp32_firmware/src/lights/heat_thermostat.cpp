@@ -0,0 +1,116 @@
+#include "lights/heat_thermostat.h"
+
+void HeatThermostat::reset()
+{
+    started = false;
+    didStep = false;
+    state = Mode::Idle;
+    iTerm = 0.0f;
+    out = 0.0f;
+    relay = false;
+}
+
+bool HeatThermostat::update(uint32_t nowMs, float tempF, float slope, bool tempValid, bool forceOff)
+{
+    didStep = false;
+    if (tempValid)
+        lastValidMs = nowMs;
+
+    if (!started)
+    {
+        started = true;
+        lastStepMs = nowMs;
+        lastValidMs = tempValid ? nowMs : nowMs - cfg.staleMs; // no grace without a reading
+        windowStartMs = nowMs;
+        windowPulseDone = false;
+        step_(nowMs, tempF, slope, tempValid, forceOff);
+    }
+    else if (nowMs - lastStepMs >= cfg.controlPeriodMs || (forceOff && state != Mode::Cutoff))
+    {
+        step_(nowMs, tempF, slope, tempValid, forceOff);
+    }
+
+    // Time-proportional window
+    if (nowMs - windowStartMs >= cfg.windowMs)
+    {
+        windowStartMs += cfg.windowMs * ((nowMs - windowStartMs) / cfg.windowMs);
+        windowPulseDone = false;
+    }
+    const bool want = !windowPulseDone && (nowMs - windowStartMs) < onMs_();
+    if (relay && !want)
+        windowPulseDone = true; // one pulse per window, even if duty rises again
+    relay = want;
+    return relay;
+}
+
+void HeatThermostat::step_(uint32_t nowMs, float tempF, float slope, bool tempValid, bool forceOff)
+{
+    const float dtMin = (nowMs - lastStepMs) / 60000.0f;
+    lastStepMs = nowMs;
+    didStep = true;
+
+    if (forceOff)
+    {
+        state = Mode::Cutoff;
+        out = 0.0f;
+        return;
+    }
+    if (!tempValid && nowMs - lastValidMs >= cfg.staleMs)
+    {
+        state = Mode::Failsafe;
+        out = cfg.failsafeDuty;
+        return;
+    }
+    if (!tempValid)
+        return; // brief gap: hold the last output
+
+    state = Mode::Pid;
+    lastTemp = tempF;
+    const float e = tune.setpointF - tempF;
+    const float pd = tune.kp * e - tune.kd * slope;
+
+    // Conditional integration: skip when the output is pinned and the error
+    // would push it further into the rail
+    const float candidate = iTerm + tune.ki * e * dtMin;
+    const float u = pd + candidate;
+    const bool pinnedHigh = u > 1.0f && e > 0.0f;
+    const bool pinnedLow = u < 0.0f && e < 0.0f;
+    if (!pinnedHigh && !pinnedLow)
+        iTerm = candidate;
+    if (iTerm < 0.0f)
+        iTerm = 0.0f;
+    else if (iTerm > 1.0f)
+        iTerm = 1.0f;
+
+    out = pd + iTerm;
+    if (out < 0.0f)
+        out = 0.0f;
+    else if (out > 1.0f)
+        out = 1.0f;
+}
+
+uint32_t HeatThermostat::onMs_() const
+{
+    uint32_t on = uint32_t(out * cfg.windowMs + 0.5f);
+    if (on < cfg.minPulseMs)
+        return 0;
+    if (cfg.windowMs - on < cfg.minPulseMs)
+        return cfg.windowMs;
+    return on;
+}
+
+const char *HeatThermostat::toString(Mode m)
+{
+    switch (m)
+    {
+    case Mode::Pid:
+        return "PID";
+    case Mode::Failsafe:
+        return "FAILSAFE";
+    case Mode::Cutoff:
+        return "CUTOFF";
+    case Mode::Idle:
+    default:
+        return "IDLE";
+    }
+}
@@ -0,0 +1,93 @@
+#ifndef HEAT_THERMOSTAT_H
+#define HEAT_THERMOSTAT_H
+
+#include <stdint.h>
+
+// Basking-spot thermostat for the heat lamp relay. Host-buildable (no Arduino
+// deps): time comes in as millis, temperature as filtered °F + slope.
+//
+//  - PID runs on a fixed control period. P and I on the error; D on the
+//    measured slope (°F/min from the probe's Kalman filter), so setpoint
+//    changes never kick and no noisy differencing is needed.
+//  - Anti-windup: the integrator only moves when the output is not saturated in
+//    the direction the error pushes, and stays inside the 0..1 output range.
+//  - Time-proportional relay: each window the lamp is on for duty × window,
+//    from the window start. Pulses shorter than minPulseMs are dropped (or
+//    stretched to the full window), and a window never turns the lamp on twice.
+//  - No valid reading for staleMs: fixed failsafeDuty. forceOff (e.g. the
+//    rate-of-rise alarm) cuts the lamp and holds the integrator.
+class HeatThermostat
+{
+public:
+    struct Tuning
+    {
+        float setpointF = 95.0f;
+        float kp = 0.08f; // duty per °F
+        float ki = 0.01f; // duty per °F·min
+        float kd = 0.0f;  // duty per °F/min of rise
+    };
+
+    struct Config
+    {
+        uint32_t controlPeriodMs = 10000;
+        uint32_t windowMs = 120000;
+        uint32_t minPulseMs = 10000; // relay / filament protection
+        uint32_t staleMs = 30000;
+        float failsafeDuty = 0.5f;
+    };
+
+    enum class Mode : uint8_t
+    {
+        Idle,     // not started (outside the schedule window)
+        Pid,
+        Failsafe, // no usable temperature
+        Cutoff    // forceOff
+    };
+
+    HeatThermostat() = default;
+    HeatThermostat(const Tuning &t, const Config &c) : tune(t), cfg(c) {}
+
+    void setTuning(const Tuning &t) { tune = t; }
+    const Tuning &tuning() const { return tune; }
+    void setConfig(const Config &c) { cfg = c; }
+    const Config &config() const { return cfg; }
+
+    // Leaving the schedule window: forget the integrator, next update starts fresh
+    void reset();
+
+    // Call often (every loop). tempValid=false when the probe is missing.
+    // Returns the relay state the lamp should have now.
+    bool update(uint32_t nowMs, float tempF, float slopeFPerMin, bool tempValid, bool forceOff = false);
+
+    // True when the last update() ran a control step (status worth publishing)
+    bool stepped() const { return didStep; }
+
+    Mode mode() const { return state; }
+    float duty() const { return out; }
+    float integral() const { return iTerm; }
+    float lastTempF() const { return lastTemp; }
+
+    static const char *toString(Mode m);
+
+private:
+    Tuning tune;
+    Config cfg;
+    Mode state = Mode::Idle;
+
+    bool started = false;
+    bool didStep = false;
+    uint32_t lastStepMs = 0;
+    uint32_t lastValidMs = 0;
+    uint32_t windowStartMs = 0;
+    bool windowPulseDone = false; // lamp already went off in this window
+    bool relay = false;
+
+    float iTerm = 0.0f;
+    float out = 0.0f;
+    float lastTemp = 0.0f;
+
+    void step_(uint32_t nowMs, float tempF, float slope, bool tempValid, bool forceOff);
+    uint32_t onMs_() const;
+};
+
+#endif // HEAT_THERMOSTAT_H
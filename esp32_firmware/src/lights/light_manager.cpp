@@ -1,9 +1,10 @@
 #include "light_manager.h"
 #include "auto_mode/auto_mode_manager.h"
+#include "Temp_sensor/temp_sensor_manager.h"
 #include "topics.h"
 #include <ArduinoJson.h>
 
-void LightManager::begin(PubSubClient *mqttClient, AutoModeManager *autoModeManager)
+void LightManager::begin(TelemetryPublisher *mqttClient, AutoModeManager *autoModeManager)
 {
     client = mqttClient;
     autoMode = autoModeManager;
@@ -15,12 +16,14 @@ void LightManager::begin(PubSubClient *mqttClient, AutoModeManager *autoModeMana
     digitalWrite(UV_LIGHT_PIN, LOW);
 
     loadScheduleFromNvs_();
+    loadThermostatFromNvs_();
     const String onS = hhmmToStr_(lightOnTime);
     const String offS = hhmmToStr_(lightOffTime);
     publishSchedule(onS.c_str(), offS.c_str());
 
     lightsAreOn = false;
     publishState(); // Start with known OFF state
+    publishThermostat();
 }
 
 void LightManager::publishCurrentSchedule()
@@ -40,14 +43,65 @@ void LightManager::updateSchedule(const DateTime &now)
 
     if (currentTime >= lightOnTime && currentTime < lightOffTime)
     {
-        turnOnBoth(); // auto logic
+        setUv_(true);
+        setHeat_(thermoEnabled ? thermostatHeat_() : true);
+        setLightsOn_(true);
     }
     else
     {
-        turnOffBoth(); // auto logic
+        thermo.reset();
+        setHeat_(false);
+        setUv_(false);
+        setLightsOn_(false);
     }
 }
 
+bool LightManager::thermostatHeat_()
+{
+    const bool valid = tempSource && tempSource->isPresent(TEMP_PROBE_BASKING);
+    const float tempF = valid ? tempSource->getTempFf(TEMP_PROBE_BASKING) : 0.0f;
+    const float slope = valid ? tempSource->getSlopeFPerMin(TEMP_PROBE_BASKING) : 0.0f;
+    const bool cutoff = tempSource && tempSource->isRiseAlarm(TEMP_PROBE_BASKING);
+
+    const bool on = thermo.update(millis(), tempF, slope, valid, cutoff);
+    if (thermo.stepped() && millis() - lastThermoPublish >= THERMO_PUBLISH_MS)
+        publishThermostat();
+    return on;
+}
+
+// Auto path: act on transitions only (the schedule runs every loop)
+void LightManager::setHeat_(bool on)
+{
+    if (on == heatIsOn)
+        return;
+    on ? heatOn() : heatOff();
+}
+
+void LightManager::setUv_(bool on)
+{
+    if (on == uvIsOn)
+        return;
+    on ? uvOn() : uvOff();
+}
+
+void LightManager::setLightsOn_(bool on)
+{
+    if (on == lightsAreOn)
+        return;
+    lightsAreOn = on;
+    publishState();
+}
+
+void LightManager::publishOutputs()
+{
+    if (!client)
+        return;
+    client->publish(TOPIC_HEAT_STATUS, heatIsOn ? "ON" : "OFF", true);
+    client->publish(TOPIC_UV_STATUS, uvIsOn ? "ON" : "OFF", true);
+    publishState();
+    publishThermostat();
+}
+
 void LightManager::turnOnBoth()
 {
 
@@ -161,6 +215,73 @@ void LightManager::saveScheduleToNvs_() const
     p.end();
 }
 
+void LightManager::setThermostat(bool enabled, const HeatThermostat::Tuning &t)
+{
+    HeatThermostat::Tuning c = t;
+    if (c.setpointF < 70.0f)
+        c.setpointF = 70.0f;
+    if (c.setpointF > 110.0f)
+        c.setpointF = 110.0f;
+    if (c.kp < 0.0f)
+        c.kp = 0.0f;
+    if (c.ki < 0.0f)
+        c.ki = 0.0f;
+    if (c.kd < 0.0f)
+        c.kd = 0.0f;
+    thermo.setTuning(c);
+    if (enabled != thermoEnabled)
+        thermo.reset(); // fresh integrator, fresh window
+    thermoEnabled = enabled;
+    saveThermostatToNvs_();
+    publishThermostat();
+}
+
+void LightManager::publishThermostat()
+{
+    if (!client)
+        return;
+    const HeatThermostat::Tuning &t = thermo.tuning();
+    JsonDocument doc;
+    doc["enabled"] = thermoEnabled;
+    doc["setpoint"] = t.setpointF;
+    doc["kp"] = t.kp;
+    doc["ki"] = t.ki;
+    doc["kd"] = t.kd;
+    doc["duty"] = thermo.duty();
+    doc["temp"] = thermo.lastTempF();
+    doc["mode"] = HeatThermostat::toString(thermo.mode());
+    char buf[192];
+    serializeJson(doc, buf, sizeof(buf));
+    client->publish(TOPIC_HEAT_THERMOSTAT, buf, true);
+    lastThermoPublish = millis();
+}
+
+void LightManager::loadThermostatFromNvs_()
+{
+    HeatThermostat::Tuning t;
+    _prefs.begin("thermo", true); // RO
+    thermoEnabled = _prefs.getBool("en", false);
+    t.setpointF = _prefs.getFloat("sp", t.setpointF);
+    t.kp = _prefs.getFloat("kp", t.kp);
+    t.ki = _prefs.getFloat("ki", t.ki);
+    t.kd = _prefs.getFloat("kd", t.kd);
+    _prefs.end();
+    thermo.setTuning(t);
+}
+
+void LightManager::saveThermostatToNvs_() const
+{
+    Preferences p;
+    p.begin("thermo", false); // RW
+    const HeatThermostat::Tuning &t = thermo.tuning();
+    p.putBool("en", thermoEnabled);
+    p.putFloat("sp", t.setpointF);
+    p.putFloat("kp", t.kp);
+    p.putFloat("ki", t.ki);
+    p.putFloat("kd", t.kd);
+    p.end();
+}
+
 void LightManager::setLightTime(int onTimeHHMM, int offTimeHHMM)
 {
     lightOnTime = clampHHMM_(onTimeHHMM);
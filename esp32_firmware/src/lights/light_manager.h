@@ -2,21 +2,37 @@
 #define LIGHT_MANAGER_H
 
 #include <Arduino.h>
-#include <PubSubClient.h>
 #include <RTClib.h>
 #include <Preferences.h>
+#include "heat_thermostat.h"
+#include "mqtt/telemetry_publisher.h"
 
 class AutoModeManager;
+class TempSensorManager;
 
 class LightManager
 {
 public:
     // Initialize with references to MQTT and AutoModeManager
-    void begin(PubSubClient *mqttClient, AutoModeManager *autoMode);
+    void begin(TelemetryPublisher *mqttClient, AutoModeManager *autoMode);
 
-    // Called regularly to check time and apply schedule logic
+    // Called regularly to check time and apply schedule logic.
+    // Outputs only switch on transitions; with the thermostat enabled the heat
+    // lamp is duty-cycled on the basking temperature inside the window.
     void updateSchedule(const DateTime &now);
 
+    // Basking probe for the thermostat (no source = schedule only)
+    void setTempSource(const TempSensorManager *temps) { tempSource = temps; }
+
+    // Thermostat tunables (persisted to NVS, republished retained)
+    void setThermostat(bool enabled, const HeatThermostat::Tuning &t);
+    bool isThermostatEnabled() const { return thermoEnabled; }
+    const HeatThermostat &thermostat() const { return thermo; }
+    void publishThermostat();
+
+    // Re-send retained heat / UV / lights state (e.g. after MQTT reconnect)
+    void publishOutputs();
+
     void publishSchedule(const char *onStr, const char *offStr);
     void publishCurrentSchedule();
     // Manual controls for both lights
@@ -41,7 +57,7 @@ public:
     int getOffHHMM() const { return lightOffTime; }
 
 private:
-    PubSubClient *client = nullptr;
+    TelemetryPublisher *client = nullptr;
     AutoModeManager *autoMode = nullptr;
 
     bool lightsAreOn = false;
@@ -63,6 +79,20 @@ private:
     bool heatIsOn = false;
     bool uvIsOn = false;
 
+    // Thermostat
+    const TempSensorManager *tempSource = nullptr;
+    HeatThermostat thermo;
+    bool thermoEnabled = false;
+    unsigned long lastThermoPublish = 0;
+    static constexpr unsigned long THERMO_PUBLISH_MS = 60000;
+
+    void setHeat_(bool on);
+    void setUv_(bool on);
+    void setLightsOn_(bool on);
+    bool thermostatHeat_();
+    void loadThermostatFromNvs_();
+    void saveThermostatToNvs_() const;
+
      // MQTT publish of "turtle/lights_state"
 };
 
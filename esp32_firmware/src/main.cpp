@@ -5,6 +5,8 @@
 #include <Adafruit_SSD1306.h>
 #include "wifi/wifi_manager.h"
 #include "mqtt/mqtt_manager.h"
+#include "mqtt/device_config.h"
+#include "mqtt/telemetry_publisher.h"
 #include "auto_mode/auto_mode_manager.h"
 #include "feeder/feeder_manager.h"
 #include "rtc/rtc_manager.h"
@@ -12,8 +14,11 @@
 #include "temp_sensor/temp_sensor_manager.h"
 #include "current_sensor/current_sensor_manager.h"
 #include "status/status_publisher.h"
+#include "status/frame_publisher.h"
 #include "oled/oled_manager.h"
 #include "mqtt/mqtt_command_router.h"
+#include "sampling/sampling_task.h"
+#include "storage/telemetry_log.h"
 
 // OLED display dimensions
 #define SCREEN_WIDTH 128
@@ -26,14 +31,19 @@ AutoModeManager autoMode;
 RtcManager rtc;
 
 WiFiManager wifi;
+DeviceConfig device; // id, topic root, broker (NVS "device")
 MqttManager mqtt;
+TelemetryPublisher telemetry; // every manager publishes through this (publish-on-change)
 
 FeederManager feeder;
 LightManager lights;
 OledManager oled;
 MqttCommandRouter cmdRouter;
+SamplingTask sampler;
+TelemetryLog telemetryLog; // broker outage → LittleFS ring, replayed after reconnect
 
-StatusPublisher statusPub(lights, feeder, autoMode, mqtt);
+StatusPublisher statusPub(lights, feeder, autoMode, telemetry);
+FramePublisher framePub(lights, feeder, autoMode, tempSensors, currents, telemetry);
 
 Adafruit_SSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, -1);
 
@@ -54,45 +64,65 @@ void setup()
   // Start Serial Monitor
   // Serial.begin(9600);
   Wire.begin();
+  Wire.setClock(400000); // ADS1115 / DS3231 / SSD1306 all do fast mode; keeps bus holds short
   rtc.begin();
   esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_ALL);
 
   // Initialize components
-  feeder.begin(&mqtt.getClient(), &autoMode);
-  autoMode.begin(&mqtt.getClient());
-  lights.begin(&mqtt.getClient(), &autoMode);
-  tempSensors.begin(mqtt.getClient(),
-                    /* baskin pin*/ 4,
-                    /* uv pin */ 5,
+  telemetry.begin(mqtt, /*heartbeatMs=*/120000);
+  feeder.begin(&telemetry, &autoMode);
+  autoMode.begin(&telemetry);
+  lights.begin(&telemetry, &autoMode);
+  lights.setTempSource(&tempSensors); // basking thermostat (enable over MQTT)
+  // Probe slots and bus pin: Temp_sensor/temp_probes.h
+  tempSensors.begin(telemetry,
+                    /* one bus, all probes */ TEMP_BUS_PIN,
                     /* read interval */ 3000,
                     /* publish interval */ 5000);
   wifi.begin();
 
+  // Channels, burdens, thresholds and ALERT pins: current_sensor/current_channels.h
+  // 860 SPS serviced by the sampling task; 3 mains cycles = 43 samples/window
+  currents.setContinuousMode(RATE_ADS1115_860SPS);
+  // Or: hardware window-comparator fault interrupts instead of streaming RMS
+  // currents.setFaultWatch(true);
   currents.begin(
-      mqtt.getClient(),
+      telemetry,
       lights,
       feeder,
-      /*publishIntervalMs=*/7000,
-      /*burdenHeat=*/0.50f,
-      /*burdenUV=*/0.50f,
-      /*thHeatA=*/0.20f,
-      /*thUvA=*/0.05f);
+      /*publishIntervalMs=*/7000);
 
-  // currents.setAutoZeroOnLightsOff(true);
+  // Zero offsets are learned online while each lamp is OFF (on by default)
+  // currents.setAutoZeroOnLightsOff(true, /*quietMs=*/2000);
+  // Harmonics / THD: one powered lamp per minute, round-robin (0 = only on capture)
+  // currents.setHarmonicsInterval(60000, /*cycles=*/6);
 
+  // Sensor acquisition on core 0; loop() (core 1) only drains and publishes
+  sampler.begin(currents, tempSensors, /*core=*/0);
+
+  // Store-and-forward: 10 s per channel while offline, ~24 records/s replay
+  telemetryLog.begin(telemetry, tempSensors, currents);
+
+  statusPub.setLinkSource(&mqtt, &wifi); // esp/link reconnect counters
+  statusPub.setSamplingSource(&sampler);  // esp/sampling task health, ADS overruns
   statusPub.begin(5000); // publish every 5s
+  framePub.begin(5000);  // packed frame next to the per-value topics (0 = off)
   //  Setup MQTT
-  mqtt.begin("172.22.80.5", 1883);
-  cmdRouter.begin(mqtt.getClient(), autoMode, feeder, lights);
+  device.load();
+  mqtt.begin(device);
+  cmdRouter.begin(mqtt, autoMode, feeder, lights, currents, tempSensors);
   cmdRouter.attach();
   mqtt.setOnReconnectSuccess([&]()
                              {
                                cmdRouter.subscribeAll();
+                               telemetry.invalidate(); // re-send everything once
                                statusPub.publishNow();
                                lights.publishCurrentSchedule();
+                               lights.publishOutputs();
+                               tempSensors.invalidate();
                                tempSensors.publishNow(); // push temps immediately on reconnect
+                               framePub.publishNow(rtc.getTime().unixtime());
                              });
-  mqtt.reconnectIfNeeded();
 
   // init oled
   initOled();
@@ -112,13 +142,8 @@ void loop()
 
   feeder.handleHallSensorTrigger();
 
-  if (wifi.isConnected())
-
-  {
-    mqtt.reconnectIfNeeded(); //  Only try if Wi-Fi is okay
-    mqtt.loop();
-    delay(5);
-  }
+  // Non-blocking: inbound commands, connect events (the MQTT task owns the socket)
+  mqtt.loop();
 
   // handleTimeSync();
   feeder.handleTimeout();
@@ -133,5 +158,12 @@ void loop()
   tempSensors.updateReadings();
   tempSensors.publishIfDue();
 
+  telemetryLog.update(now.unixtime());
+  framePub.update(now.unixtime());
+
   statusPub.update();
+
+  // Yield a tick: the MQTT and sampling tasks do the waiting, loop() only
+  // needs to come round every few ms (and must not starve core 1's idle task)
+  vTaskDelay(1);
 }
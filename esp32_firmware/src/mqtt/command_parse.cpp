@@ -0,0 +1,240 @@
+#include "mqtt/command_parse.h"
+#include <stdlib.h>
+
+namespace cmdparse
+{
+    static inline bool isSpace(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n'; }
+    static inline char toLower(char c) { return (c >= 'A' && c <= 'Z') ? char(c + ('a' - 'A')) : c; }
+
+    void Span::copyTo(char *out, size_t len) const
+    {
+        if (!len)
+            return;
+        const size_t k = n < len - 1 ? n : len - 1;
+        if (k)
+            memcpy(out, p, k);
+        out[k] = '\0';
+    }
+
+    Span trim(const char *p, size_t n)
+    {
+        while (n && isSpace(*p))
+        {
+            ++p;
+            --n;
+        }
+        while (n && isSpace(p[n - 1]))
+            --n;
+        return Span{p, n};
+    }
+
+    bool tokenIs(Span s, const char *lit)
+    {
+        size_t i = 0;
+        for (; i < s.n; ++i)
+        {
+            if (!lit[i] || toLower(s.p[i]) != lit[i])
+                return false;
+        }
+        return lit[i] == '\0';
+    }
+
+    int parseHHMM(Span s)
+    {
+        s = trim(s.p, s.n);
+        int hh = 0, mm = 0, digits = 0;
+        size_t i = 0;
+        for (; i < s.n && s.p[i] >= '0' && s.p[i] <= '9' && digits < 2; ++i, ++digits)
+            hh = hh * 10 + (s.p[i] - '0');
+        if (!digits)
+            return -1;
+        if (i < s.n)
+        {
+            if (s.p[i++] != ':')
+                return -1;
+            digits = 0;
+            for (; i < s.n && s.p[i] >= '0' && s.p[i] <= '9' && digits < 2; ++i, ++digits)
+                mm = mm * 10 + (s.p[i] - '0');
+            if (digits != 2 || i != s.n)
+                return -1;
+        }
+        if (hh > 23 || mm > 59)
+            return -1;
+        return hh * 100 + mm;
+    }
+
+    // ---------- FlatJson ----------
+
+    namespace
+    {
+        struct Cursor
+        {
+            const char *p;
+            const char *end;
+
+            void ws()
+            {
+                while (p < end && isSpace(*p))
+                    ++p;
+            }
+            bool eat(char c)
+            {
+                ws();
+                if (p < end && *p == c)
+                {
+                    ++p;
+                    return true;
+                }
+                return false;
+            }
+            // "..." → span without quotes; escapes are skipped over, not decoded
+            bool string(Span &out, bool allowEscapes)
+            {
+                ws();
+                if (p >= end || *p != '"')
+                    return false;
+                const char *start = ++p;
+                while (p < end && *p != '"')
+                {
+                    if (*p == '\\')
+                    {
+                        if (!allowEscapes || ++p >= end)
+                            return false;
+                    }
+                    ++p;
+                }
+                if (p >= end)
+                    return false;
+                out = Span{start, size_t(p - start)};
+                ++p;
+                return true;
+            }
+            bool literal(const char *lit, Span &out)
+            {
+                const size_t n = strlen(lit);
+                if (size_t(end - p) < n || memcmp(p, lit, n) != 0)
+                    return false;
+                out = Span{p, n};
+                p += n;
+                return true;
+            }
+            bool number(Span &out)
+            {
+                const char *start = p;
+                while (p < end && ((*p >= '0' && *p <= '9') || *p == '-' || *p == '+' ||
+                                   *p == '.' || *p == 'e' || *p == 'E'))
+                    ++p;
+                out = Span{start, size_t(p - start)};
+                return p != start;
+            }
+        };
+    }
+
+    bool FlatJson::parse(const uint8_t *data, size_t n)
+    {
+        count = 0;
+        Cursor c{reinterpret_cast<const char *>(data), reinterpret_cast<const char *>(data) + n};
+        if (!c.eat('{'))
+            return false;
+        if (c.eat('}'))
+        {
+            c.ws();
+            return c.p == c.end;
+        }
+        for (;;)
+        {
+            if (count >= MAX_FIELDS)
+                return false;
+            Field &f = fields[count];
+            if (!c.string(f.key, false) || !c.eat(':'))
+                return false;
+            c.ws();
+            if (c.p >= c.end)
+                return false;
+            const char ch = *c.p;
+            bool ok;
+            if (ch == '"')
+            {
+                ok = c.string(f.value, true);
+                f.type = Type::String;
+            }
+            else if (ch == 't' || ch == 'f')
+            {
+                ok = c.literal(ch == 't' ? "true" : "false", f.value);
+                f.type = Type::Bool;
+            }
+            else if (ch == 'n')
+            {
+                ok = c.literal("null", f.value);
+                f.type = Type::Null;
+            }
+            else
+            {
+                ok = c.number(f.value); // '{' / '[' (nesting) fail here
+                f.type = Type::Number;
+            }
+            if (!ok)
+                return false;
+            ++count;
+            if (c.eat(','))
+                continue;
+            if (!c.eat('}'))
+                return false;
+            c.ws();
+            return c.p == c.end;
+        }
+    }
+
+    const FlatJson::Field *FlatJson::find_(const char *key) const
+    {
+        const size_t n = strlen(key);
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (fields[i].key.n == n && memcmp(fields[i].key.p, key, n) == 0)
+                return &fields[i];
+        }
+        return nullptr;
+    }
+
+    bool FlatJson::getString(const char *key, Span &out) const
+    {
+        const Field *f = find_(key);
+        if (!f || f->type != Type::String)
+            return false;
+        out = f->value;
+        return true;
+    }
+
+    bool FlatJson::getFloat(const char *key, float &out) const
+    {
+        const Field *f = find_(key);
+        if (!f || f->type != Type::Number || f->value.n >= 24)
+            return false;
+        char buf[24]; // strtof needs a terminator; the payload has none
+        f->value.copyTo(buf, sizeof(buf));
+        char *end = nullptr;
+        const float v = strtof(buf, &end);
+        if (end != buf + f->value.n)
+            return false;
+        out = v;
+        return true;
+    }
+
+    bool FlatJson::getBool(const char *key, bool &out) const
+    {
+        const Field *f = find_(key);
+        if (!f || f->type != Type::Bool)
+            return false;
+        out = f->value.n == 4; // "true"
+        return true;
+    }
+
+    bool FlatJson::getScalar(const char *key, Span &out) const
+    {
+        const Field *f = find_(key);
+        if (!f || (f->type != Type::String && f->type != Type::Number))
+            return false;
+        out = f->value;
+        return true;
+    }
+}
@@ -0,0 +1,166 @@
+#ifndef COMMAND_PARSE_H
+#define COMMAND_PARSE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// Allocation-free building blocks for MqttCommandRouter. Host-buildable (no
+// Arduino deps). Everything works in place on the payload PubSubClient hands
+// over; nothing is copied to the heap.
+//
+//  - TopicTable: perfect hash over the command topics, built at compile time.
+//    One FNV-1a pass over the incoming topic, one slot probe, one memcmp.
+//  - tokenIs(): case-insensitive, whitespace-trimmed compare on the raw bytes.
+//  - FlatJson: fixed-capacity parser for flat objects ({"k":v,...}, values are
+//    strings, numbers, true/false/null). Fields are spans into the payload.
+namespace cmdparse
+{
+    struct Span
+    {
+        const char *p = nullptr;
+        size_t n = 0;
+
+        bool empty() const { return n == 0; }
+        // NUL-terminated copy into out (truncated to len-1); for APIs that want C strings
+        void copyTo(char *out, size_t len) const;
+    };
+
+    // ---------- topic dispatch ----------
+
+    constexpr size_t cstrLen(const char *s)
+    {
+        size_t n = 0;
+        while (s[n])
+            ++n;
+        return n;
+    }
+
+    constexpr uint32_t fnv1a(const char *s, size_t n, uint32_t seed)
+    {
+        uint32_t h = 2166136261u ^ seed;
+        for (size_t i = 0; i < n; ++i)
+        {
+            h ^= uint8_t(s[i]);
+            h *= 16777619u;
+        }
+        return h;
+    }
+
+    struct Route
+    {
+        const char *topic; // full topic, incl. root
+        uint8_t id;        // caller's command enum
+    };
+
+    // SLOTS is a power of two; route i lives in slot[hash(topic) & (SLOTS-1)].
+    // The seed is searched at compile time until no two routes share a slot.
+    template <size_t N, size_t SLOTS>
+    struct TopicTable
+    {
+        static_assert((SLOTS & (SLOTS - 1)) == 0 && SLOTS >= N, "SLOTS: power of two >= routes");
+        static constexpr uint8_t EMPTY = 0xFF;
+        static constexpr uint32_t MAX_SEED = 4096;
+
+        uint32_t seed = MAX_SEED; // MAX_SEED = none found
+        uint8_t slot[SLOTS] = {};
+        uint8_t len[N] = {};
+        const char *topic[N] = {};
+        uint8_t id[N] = {};
+
+        constexpr explicit TopicTable(const Route (&routes)[N])
+        {
+            for (size_t i = 0; i < N; ++i)
+            {
+                topic[i] = routes[i].topic;
+                len[i] = uint8_t(cstrLen(routes[i].topic));
+                id[i] = routes[i].id;
+            }
+            for (uint32_t s = 0; s < MAX_SEED; ++s)
+            {
+                for (size_t k = 0; k < SLOTS; ++k)
+                    slot[k] = EMPTY;
+                bool ok = true;
+                for (size_t i = 0; i < N && ok; ++i)
+                {
+                    const size_t k = fnv1a(topic[i], len[i], s) & (SLOTS - 1);
+                    ok = slot[k] == EMPTY;
+                    slot[k] = uint8_t(i);
+                }
+                if (ok)
+                {
+                    seed = s;
+                    return;
+                }
+            }
+        }
+
+        constexpr bool valid() const { return seed < MAX_SEED; }
+
+        // Route id, or `unknown` when the topic is not in the table
+        uint8_t find(const char *t, uint8_t unknown) const
+        {
+            const size_t n = strlen(t);
+            const uint8_t i = slot[fnv1a(t, n, seed) & (SLOTS - 1)];
+            if (i == EMPTY || len[i] != n || memcmp(topic[i], t, n) != 0)
+                return unknown;
+            return id[i];
+        }
+    };
+
+    // ---------- payload tokens ----------
+
+    Span trim(const char *p, size_t n);
+    // Case-insensitive compare of the trimmed payload against a lower-case literal
+    bool tokenIs(Span s, const char *lowerLiteral);
+    inline bool tokenIs(const uint8_t *p, size_t n, const char *lowerLiteral)
+    {
+        return tokenIs(trim(reinterpret_cast<const char *>(p), n), lowerLiteral);
+    }
+
+    // "HH:MM" → HHMM (e.g. "07:30" → 730); -1 if malformed
+    int parseHHMM(Span s);
+
+    // ---------- flat JSON ----------
+
+    class FlatJson
+    {
+    public:
+        static constexpr size_t MAX_FIELDS = 8;
+
+        enum class Type : uint8_t
+        {
+            String,
+            Number,
+            Bool,
+            Null
+        };
+
+        // False on malformed input, nesting, escapes in keys or more than MAX_FIELDS
+        bool parse(const uint8_t *p, size_t n);
+
+        bool has(const char *key) const { return find_(key) != nullptr; }
+        // Present and of the right type → value written, true; else out untouched
+        bool getString(const char *key, Span &out) const;
+        bool getFloat(const char *key, float &out) const;
+        bool getBool(const char *key, bool &out) const;
+        // String or number, as a span (IDs and tokens sent either way: "7" / 7)
+        bool getScalar(const char *key, Span &out) const;
+
+        size_t size() const { return count; }
+
+    private:
+        struct Field
+        {
+            Span key;
+            Span value; // string: without quotes; others: the literal
+            Type type;
+        };
+        Field fields[MAX_FIELDS];
+        size_t count = 0;
+
+        const Field *find_(const char *key) const;
+    };
+}
+
+#endif // COMMAND_PARSE_H
@@ -0,0 +1,49 @@
+#include "mqtt/device_config.h"
+#include <Preferences.h>
+#include "topics.h"
+
+static void copyStr(char *out, size_t len, const String &s)
+{
+    strncpy(out, s.c_str(), len - 1);
+    out[len - 1] = '\0';
+}
+
+bool DeviceConfig::validRoot_(const char *r)
+{
+    const size_t n = strlen(r);
+    if (n < 2 || n >= ROOT_MAX || r[n - 1] != '/' || r[0] == '/')
+        return false;
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (r[i] == '+' || r[i] == '#' || (r[i] == '/' && r[i + 1] == '/'))
+            return false;
+    }
+    return true;
+}
+
+void DeviceConfig::load()
+{
+    char macId[ID_MAX];
+    const uint64_t mac = ESP.getEfuseMac(); // byte 0 = first MAC byte
+    snprintf(macId, sizeof(macId), "turtle-%02x%02x%02x",
+             uint8_t(mac >> 24), uint8_t(mac >> 32), uint8_t(mac >> 40));
+
+    Preferences prefs;
+    prefs.begin("device", true);
+    copyStr(id, ID_MAX, prefs.getString("id", macId));
+    copyStr(root, ROOT_MAX, prefs.getString("root", TOPIC_ROOT_DEFAULT));
+    copyStr(host, HOST_MAX, prefs.getString("host", "172.22.80.5"));
+    port = prefs.getUShort("port", 1883);
+    copyStr(user, USER_MAX, prefs.getString("user", ""));
+    copyStr(pass, PASS_MAX, prefs.getString("pass", ""));
+    prefs.end();
+
+    if (!id[0])
+        copyStr(id, ID_MAX, macId);
+    if (!validRoot_(root))
+    {
+        Serial.printf("[Device] bad topic root \"%s\"; using %s\n", root, TOPIC_ROOT_DEFAULT);
+        copyStr(root, ROOT_MAX, TOPIC_ROOT_DEFAULT);
+    }
+    Serial.printf("[Device] id=%s root=%s broker=%s:%u\n", id, root, host, port);
+}
@@ -0,0 +1,40 @@
+#ifndef DEVICE_CONFIG_H
+#define DEVICE_CONFIG_H
+
+#include <Arduino.h>
+
+// Per-device identity and broker settings, read from NVS namespace "device"
+// at boot (write them with wifi_config/preference.cpp). Missing keys fall back
+// to the defaults, which match the single-tank setup:
+//   id    client ID             default "turtle-<last 3 MAC bytes>"
+//   root  topic root            default TOPIC_ROOT_DEFAULT ("turtle/")
+//   host  broker                default "172.22.80.5"
+//   port  broker port           default 1883
+//   user / pass                 default none
+// Fixed buffers, no String kept around: MqttManager and PubSubClient point
+// into this struct for the lifetime of the firmware.
+struct DeviceConfig
+{
+    static constexpr size_t ID_MAX = 33;   // incl. NUL
+    static constexpr size_t ROOT_MAX = 32; // incl. NUL
+    static constexpr size_t HOST_MAX = 64;
+    static constexpr size_t USER_MAX = 33;
+    static constexpr size_t PASS_MAX = 65;
+
+    char id[ID_MAX] = {0};
+    char root[ROOT_MAX] = {0};
+    char host[HOST_MAX] = {0};
+    uint16_t port = 1883;
+    char user[USER_MAX] = {0};
+    char pass[PASS_MAX] = {0};
+
+    void load();
+
+    size_t rootLen() const { return strlen(root); }
+
+private:
+    // Root must end in '/' and hold no wildcard or empty level
+    static bool validRoot_(const char *r);
+};
+
+#endif // DEVICE_CONFIG_H
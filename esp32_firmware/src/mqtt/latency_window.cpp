@@ -0,0 +1,33 @@
+#include "mqtt/latency_window.h"
+#include <algorithm>
+#include <string.h>
+
+void LatencyWindow::add(uint32_t us)
+{
+    ring[head] = us;
+    head = (head + 1) % N;
+    if (filled < N)
+        ++filled;
+    ++count;
+}
+
+uint32_t LatencyWindow::percentile(float p) const
+{
+    if (!filled)
+        return 0;
+    uint32_t tmp[N];
+    memcpy(tmp, ring, filled * sizeof(uint32_t)); // first `filled` slots are the valid ones
+    // Nearest rank: ceil(p/100 * n), 1-based
+    size_t rank = size_t(p / 100.0f * filled + 0.999f);
+    rank = rank < 1 ? 1 : (rank > filled ? filled : rank);
+    std::nth_element(tmp, tmp + rank - 1, tmp + filled);
+    return tmp[rank - 1];
+}
+
+uint32_t LatencyWindow::maxUs() const
+{
+    uint32_t m = 0;
+    for (size_t i = 0; i < filled; ++i)
+        m = ring[i] > m ? ring[i] : m;
+    return m;
+}
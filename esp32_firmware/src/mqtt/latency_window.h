@@ -0,0 +1,30 @@
+#ifndef LATENCY_WINDOW_H
+#define LATENCY_WINDOW_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Rolling window of the last N latencies (µs) with percentiles on demand.
+// Host-buildable. add() is O(1); percentile() sorts a stack copy, so call it
+// when publishing, not per sample.
+class LatencyWindow
+{
+public:
+    static constexpr size_t N = 128;
+
+    void add(uint32_t us);
+    // p in 0..100 (nearest rank); 0 when empty
+    uint32_t percentile(float p) const;
+    uint32_t maxUs() const;
+
+    size_t size() const { return filled; }
+    uint32_t total() const { return count; } // since boot
+
+private:
+    uint32_t ring[N] = {0};
+    size_t head = 0;
+    size_t filled = 0;
+    uint32_t count = 0;
+};
+
+#endif // LATENCY_WINDOW_H
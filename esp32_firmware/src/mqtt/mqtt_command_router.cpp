@@ -1,21 +1,88 @@
 #include "mqtt/mqtt_command_router.h"
+#include "mqtt/mqtt_manager.h"
 #include "auto_mode/auto_mode_manager.h"
 #include "feeder/feeder_manager.h"
 #include "lights/light_manager.h"
+#include "current_sensor/current_sensor_manager.h"
+#include "Temp_sensor/temp_sensor_manager.h"
 #include "topics.h"
-#include <ArduinoJson.h>
+#include "mqtt/command_parse.h"
+#include "esp_timer.h" // esp_timer_get_time
+
+using cmdparse::FlatJson;
+using cmdparse::Span;
+using cmdparse::tokenIs;
 
 MqttCommandRouter *MqttCommandRouter::self = nullptr;
 
-void MqttCommandRouter::begin(PubSubClient &client,
+namespace
+{
+    enum Command : uint8_t
+    {
+        CMD_FEEDER,
+        CMD_AUTO_MODE,
+        CMD_LIGHTS,
+        CMD_HEAT,
+        CMD_UV,
+        CMD_REBOOT,
+        CMD_SCHEDULE,
+        CMD_THERMOSTAT,
+        CMD_CAPTURE,
+        CMD_PROBES,
+        CMD_UNKNOWN
+    };
+
+    constexpr cmdparse::Route ROUTES[] = {
+        {TOPIC_FEEDER_CMD, CMD_FEEDER},
+        {TOPIC_AUTO_MODE_CMD, CMD_AUTO_MODE},
+        {TOPIC_LIGHTS_CMD, CMD_LIGHTS},
+        {TOPIC_HEAT_CMD, CMD_HEAT},
+        {TOPIC_UV_CMD, CMD_UV},
+        {TOPIC_REBOOT_CMD, CMD_REBOOT},
+        {TOPIC_LIGHTS_SCHEDULE_CMD, CMD_SCHEDULE},
+        {TOPIC_HEAT_THERMOSTAT_CMD, CMD_THERMOSTAT},
+        {TOPIC_CURRENT_CAPTURE_CMD, CMD_CAPTURE},
+        {TOPIC_TEMP_PROBES_CMD, CMD_PROBES},
+    };
+    constexpr size_t ROUTE_COUNT = sizeof(ROUTES) / sizeof(ROUTES[0]);
+
+    constexpr cmdparse::TopicTable<ROUTE_COUNT, 16> TOPIC_TABLE(ROUTES);
+    static_assert(TOPIC_TABLE.valid(), "command topics: no collision-free hash seed (raise SLOTS)");
+
+    // Leading '{' after whitespace
+    bool looksLikeJson(const byte *p, unsigned int n)
+    {
+        const Span s = cmdparse::trim(reinterpret_cast<const char *>(p), n);
+        return s.n && s.p[0] == '{';
+    }
+
+    const char *const REASON_NAMES[] = {"applied", "auto_mode", "bad_payload", "busy", "unknown_channel", "rejected"};
+
+    constexpr size_t ID_MAX = 32; // echoed correlation ID, longer is truncated
+}
+
+struct MqttCommandRouter::Envelope
+{
+    Span token;   // plain payload (trimmed), or the envelope's "cmd"
+    Span id;      // correlation ID; empty = nobody is waiting for an ack
+    FlatJson doc; // fields of a JSON payload
+    bool json = false;   // payload starts with '{'
+    bool jsonOk = false; // ... and parsed
+};
+
+void MqttCommandRouter::begin(MqttManager &transport,
                               AutoModeManager &autoModeRef,
                               FeederManager &feederRef,
-                              LightManager &lightsRef)
+                              LightManager &lightsRef,
+                              CurrentSensorManager &currentsRef,
+                              TempSensorManager &tempsRef)
 {
-    mqtt = &client;
+    mqtt = &transport;
     autoMode = &autoModeRef;
     feeder = &feederRef;
     lights = &lightsRef;
+    currents = &currentsRef;
+    temps = &tempsRef;
     self = this;
 }
 
@@ -38,8 +105,8 @@ void MqttCommandRouter::subscribeAll()
     }
 
     // ---- Option B: wildcards (comment out A if you prefer this) ----
-    // mqtt->subscribe(TOPIC_ROOT "+/cmd");     // feeder/cmd, lights/cmd, auto_mode/cmd
-    // mqtt->subscribe(TOPIC_ROOT "+/+/cmd");   // lights/heat/cmd, lights/uv/cmd, lights/schedule/cm
+    // mqtt->subscribe("+/cmd");     // feeder/cmd, lights/cmd, auto_mode/cmd (under this device's root)
+    // mqtt->subscribe("+/+/cmd");   // lights/heat/cmd, lights/uv/cmd, lights/schedule/cmd
 }
 
 // static
@@ -49,118 +116,246 @@ void MqttCommandRouter::bridge(char *topic, byte *payload, unsigned int length)
         self->handle(topic, payload, length);
 }
 
+// No heap on this path: the topic is hashed in place, tokens are compared on
+// the raw payload and JSON is parsed into spans over it, once.
 void MqttCommandRouter::handle(const char *topic, const byte *payload, unsigned int length)
 {
-    if (!mqtt || !autoMode || !feeder || !lights || !topic)
+    if (!mqtt || !autoMode || !feeder || !lights || !currents || !temps || !topic)
         return;
 
-    const String msg = toString(payload, length);
-    const String msgLower = lower(msg);
-    // Serial.printf("MQTT in [%s]: %s\n", topic, msg.c_str());
+    const uint8_t cmd = TOPIC_TABLE.find(topic, CMD_UNKNOWN);
+    if (cmd == CMD_UNKNOWN)
+        return; // Unknown topic → ignore
+    const uint64_t rxUs = mqtt->receivedUs();
 
-    //  Feed -----------------------------------------------------------
-    if (topicIs(topic, TOPIC_FEEDER_CMD))
+    Envelope env;
+    env.token = cmdparse::trim(reinterpret_cast<const char *>(payload), length);
+    if (looksLikeJson(payload, length))
     {
-        if (autoMode->isEnabled())
-        {
-            Serial.println(F("Feed ignored — Auto Mode is ON"));
-            return;
-        }
-        if (msgLower == "1" || msgLower == "feed")
+        env.json = true;
+        env.jsonOk = env.doc.parse(payload, length);
+        env.token = Span{};
+        if (env.jsonOk)
         {
-            feeder->runManual();
+            env.doc.getScalar("id", env.id);
+            env.doc.getScalar("cmd", env.token);
         }
-        return;
     }
 
-    //  Auto mode on/off ----------------------------------------------
-    if (topicIs(topic, TOPIC_AUTO_MODE_CMD))
+    const Reason r = dispatch_(cmd, env);
+    const uint64_t actUs = esp_timer_get_time();
+
+    if (r == R_APPLIED)
     {
-        autoMode->setEnabled(msgLower == "on");
-        return;
+        const uint64_t us = actUs - rxUs;
+        lat.add(us > UINT32_MAX ? UINT32_MAX : uint32_t(us));
     }
+    else
+    {
+        ++nacks;
+        Serial.printf("[CMD] %s: %s\n", topic, REASON_NAMES[r]);
+    }
+    acknowledge_(topic, env, r, rxUs, actUs);
+    publishLatency_();
 
-    // Lights on/off --------------------------------------------------
-    if (topicIs(topic, TOPIC_LIGHTS_CMD))
+    if (cmd == CMD_REBOOT && r == R_APPLIED)
+    {
+        delay(250); // network task drains the ack on its idle poll
+        ESP.restart();
+    }
+}
+
+MqttCommandRouter::Reason MqttCommandRouter::dispatch_(uint8_t cmd, const Envelope &env)
+{
+    const Span &tok = env.token;
+    switch (cmd)
     {
+    //  Feed -----------------------------------------------------------
+    case CMD_FEEDER:
         if (autoMode->isEnabled())
-            return; // respect Auto Mode
-        if (msgLower == "on")
-        {
+            return R_AUTO_MODE;
+        if (!tokenIs(tok, "1") && !tokenIs(tok, "feed"))
+            return R_BAD_PAYLOAD;
+        if (feeder->isRunning())
+            return R_BUSY;
+        feeder->runManual();
+        return R_APPLIED;
+
+    //  Auto mode on/off ----------------------------------------------
+    case CMD_AUTO_MODE:
+        if (tokenIs(tok, "on"))
+            autoMode->setEnabled(true);
+        else if (tokenIs(tok, "off"))
+            autoMode->setEnabled(false);
+        else
+            return R_BAD_PAYLOAD;
+        return R_APPLIED;
+
+    // Lights on/off --------------------------------------------------
+    case CMD_LIGHTS:
+        if (autoMode->isEnabled())
+            return R_AUTO_MODE; // respect Auto Mode
+        if (tokenIs(tok, "on"))
             lights->turnOnBoth();
-        }
-        else if (msgLower == "off")
-        {
+        else if (tokenIs(tok, "off"))
             lights->turnOffBoth();
-        }
-        return;
-    }
+        else
+            return R_BAD_PAYLOAD;
+        return R_APPLIED;
 
     // heat_bulb ---------------------------------------------------------
-    if (topicIs(topic, TOPIC_HEAT_CMD))
-    {
+    case CMD_HEAT:
         if (autoMode->isEnabled())
-            return;
-        if (msgLower == "on")
-        {
+            return R_AUTO_MODE;
+        if (tokenIs(tok, "on"))
             lights->heatOn();
-        }
-        else if (msgLower == "off")
-        {
+        else if (tokenIs(tok, "off"))
             lights->heatOff();
-        }
-        return;
-    }
+        else
+            return R_BAD_PAYLOAD;
+        return R_APPLIED;
 
     // uv_bulb -----------------------------------------------------------
-    if (topicIs(topic, TOPIC_UV_CMD))
-    {
+    case CMD_UV:
         if (autoMode->isEnabled())
-            return;
-        if (msgLower == "on")
-        {
+            return R_AUTO_MODE;
+        if (tokenIs(tok, "on"))
             lights->uvOn();
-        }
-        else if (msgLower == "off")
-        {
+        else if (tokenIs(tok, "off"))
             lights->uvOff();
-        }
-        return;
+        else
+            return R_BAD_PAYLOAD;
+        return R_APPLIED;
+
+    // reboot (the restart itself happens after the ack is queued) ------
+    case CMD_REBOOT:
+        return tokenIs(tok, "1") || tokenIs(tok, "now") ? R_APPLIED : R_BAD_PAYLOAD;
+
+    // schedule ----------------------------------------------------------
+    case CMD_SCHEDULE:
+    {
+        // {"on":"HH:MM","off":"HH:MM"}; a missing side takes the old default
+        if (!env.jsonOk)
+            return R_BAD_PAYLOAD;
+        int on = 800, off = 1800;
+        Span v;
+        if (env.doc.getString("on", v))
+            on = cmdparse::parseHHMM(v);
+        if (env.doc.getString("off", v))
+            off = cmdparse::parseHHMM(v);
+        if (on < 0 || off < 0)
+            return R_BAD_PAYLOAD; // expected HH:MM
+        lights->setLightTime(on, off); // persists to NVS + republishes retained schedule
+        return R_APPLIED;
     }
 
-    // reboot ------------------------------------------------------------
-    if (topicIs(topic, TOPIC_REBOOT_CMD))
+    // heat thermostat --------------------------------------------------
+    case CMD_THERMOSTAT:
     {
-        if (msgLower == "1" || msgLower == "now")
+        // Any subset of {"enabled":true,"setpoint":95,"kp":0.08,"ki":0.01,"kd":0}
+        if (!env.jsonOk)
+            return R_BAD_PAYLOAD;
+        HeatThermostat::Tuning t = lights->thermostat().tuning();
+        env.doc.getFloat("setpoint", t.setpointF);
+        env.doc.getFloat("kp", t.kp);
+        env.doc.getFloat("ki", t.ki);
+        env.doc.getFloat("kd", t.kd);
+        bool enabled = lights->isThermostatEnabled();
+        env.doc.getBool("enabled", enabled);
+        lights->setThermostat(enabled, t); // persists + republishes
+        return R_APPLIED;
+    }
+
+    // waveform capture ------------------------------------------------
+    case CMD_CAPTURE:
+    {
+        // "all" | "<channel>" | {"channel":"uv","cycles":12}
+        Span chName = tok;
+        uint8_t cycles = 0; // manager default
+        if (env.json)
         {
-            delay(50);
-            ESP.restart();
+            if (!env.jsonOk)
+                return R_BAD_PAYLOAD;
+            chName = Span{"all", 3};
+            env.doc.getString("channel", chName);
+            float c = 0.0f;
+            if (env.doc.getFloat("cycles", c) && c > 0.0f)
+                cycles = c > 255.0f ? 255 : uint8_t(c);
         }
-        return;
+
+        char name[16];
+        chName.copyTo(name, sizeof(name)); // findChannel is case-insensitive
+        const bool all = tokenIs(chName, "all");
+        const int ch = all ? CurrentSensorManager::CAPTURE_ALL : currents->findChannel(name);
+        if (ch == -1 && !all)
+        {
+            mqtt->publish(TOPIC_CURRENT_CAPTURE_STATUS, "error:unknown channel", false);
+            return R_UNKNOWN_CHANNEL;
+        }
+        // Busy or not streaming; applied = recording requested, chunks follow
+        return currents->requestCapture(ch, cycles) ? R_APPLIED : R_BUSY;
     }
 
-    if (topicIs(topic, TOPIC_LIGHTS_SCHEDULE_CMD))
+    // DS18B20 probes ---------------------------------------------------
+    case CMD_PROBES:
     {
-        // Payload is raw bytes from PubSubClient; parse without copying
-        JsonDocument doc;
-        DeserializationError err = deserializeJson(doc, payload, length);
-        if (!err)
+        if (tokenIs(tok, "rescan"))
         {
-            const char *onStr = doc["on"] | "08:00";
-            const char *offStr = doc["off"] | "18:00";
-
-            auto toHHMM = [](const char *s) -> int
-            {
-                int hh = atoi(s);
-                const char *c = strchr(s, ':');
-                int mm = c ? atoi(c + 1) : 0;
-                return hh * 100 + mm;
-            };
-
-            lights->setLightTime(toHHMM(onStr), toHHMM(offStr)); // persists to NVS + republishes retained schedule
+            temps->requestRescan();
+            return R_APPLIED;
         }
-        return;
+        if (!env.jsonOk)
+            return R_BAD_PAYLOAD;
+        Span slotSpan, romSpan;
+        env.doc.getString("assign", slotSpan);
+        env.doc.getString("rom", romSpan);
+        char slot[16], rom[24];
+        slotSpan.copyTo(slot, sizeof(slot));
+        romSpan.copyTo(rom, sizeof(rom));
+        return temps->requestAssign(slot, rom) ? R_APPLIED : R_REJECTED; // bad slot/rom
     }
 
-    // Unknown topic → ignore
+    default:
+        return R_BAD_PAYLOAD;
+    }
+}
+
+void MqttCommandRouter::acknowledge_(const char *topic, const Envelope &env, Reason r, uint64_t rxUs, uint64_t actUs)
+{
+    if (env.id.empty())
+        return; // plain command: fire-and-forget as before
+
+    // The ID is echoed inside a JSON string: drop quotes, backslashes, controls
+    char id[ID_MAX + 1];
+    size_t n = 0;
+    for (size_t i = 0; i < env.id.n && n < ID_MAX; ++i)
+    {
+        const char c = env.id.p[i];
+        if (uint8_t(c) >= 0x20 && c != '"' && c != '\\')
+            id[n++] = c;
+    }
+    id[n] = '\0';
+
+    char buf[192];
+    int len = snprintf(buf, sizeof(buf), "{\"id\":\"%s\",\"topic\":\"%s\",\"ok\":%s,\"reason\":\"%s\",\"rx_ms\":%lu",
+                       id, topic, r == R_APPLIED ? "true" : "false", REASON_NAMES[r],
+                       (unsigned long)(rxUs / 1000ULL));
+    if (r == R_APPLIED && len > 0 && size_t(len) < sizeof(buf))
+        len += snprintf(buf + len, sizeof(buf) - len, ",\"act_ms\":%lu,\"lat_us\":%lu",
+                        (unsigned long)(actUs / 1000ULL), (unsigned long)(actUs - rxUs));
+    if (len > 0 && size_t(len) + 1 < sizeof(buf))
+    {
+        buf[len] = '}';
+        buf[len + 1] = '\0';
+        mqtt->publish(TOPIC_CMD_ACK, buf, false);
+    }
+}
+
+void MqttCommandRouter::publishLatency_()
+{
+    char buf[112];
+    snprintf(buf, sizeof(buf), "{\"n\":%lu,\"p50_us\":%lu,\"p99_us\":%lu,\"max_us\":%lu,\"nacks\":%lu}",
+             (unsigned long)lat.total(), (unsigned long)lat.percentile(50.0f),
+             (unsigned long)lat.percentile(99.0f), (unsigned long)lat.maxUs(), (unsigned long)nacks);
+    mqtt->publish(TOPIC_ESP_CMD_LATENCY, buf, true);
 }
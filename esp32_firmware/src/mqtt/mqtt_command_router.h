@@ -2,59 +2,68 @@
 #define MQTT_COMMAND_ROUTER_H
 
 #include <Arduino.h>
-#include <PubSubClient.h>
+#include "mqtt/latency_window.h"
 
 // Forward declarations
 class AutoModeManager;
 class FeederManager;
 class LightManager;
+class CurrentSensorManager;
+class TempSensorManager;
+class MqttManager;
 
 class MqttCommandRouter
 {
 public:
     MqttCommandRouter() = default;
 
-    void begin(PubSubClient &client,
+    void begin(MqttManager &transport,
                AutoModeManager &autoModeRef,
                FeederManager &feederRef,
-               LightManager &lightsRef);
+               LightManager &lightsRef,
+               CurrentSensorManager &currentsRef,
+               TempSensorManager &tempsRef);
 
-    // Install this router as PubSubClient's callback
+    // Install this router as the transport's inbound callback (runs in loop())
     void attach();
 
     // Subscribe to control topics (call after connect / reconnect)
     void subscribeAll();
 
+    // Receipt → actuation (µs) of the last LatencyWindow::N applied commands
+    const LatencyWindow &latency() const { return lat; }
+    uint32_t nackCount() const { return nacks; }
+
 private:
-    // PubSubClient requires a static callback → bridge into instance
+    // Result of one command; names go out in the ack ("reason")
+    enum Reason : uint8_t
+    {
+        R_APPLIED,
+        R_AUTO_MODE,       // manual control refused while Auto Mode is on
+        R_BAD_PAYLOAD,     // unknown token, malformed JSON / HH:MM
+        R_BUSY,            // feeder already running, capture in progress
+        R_UNKNOWN_CHANNEL, // capture: no such current channel
+        R_REJECTED         // manager refused the arguments (probe slot/ROM)
+    };
+    struct Envelope; // parsed payload (command_parse types stay out of this header)
+
+    // Transport takes a plain callback → bridge into instance
     static void bridge(char *topic, byte *payload, unsigned int length);
     void handle(const char *topic, const byte *payload, unsigned int length);
-
-    // Helpers
-    static inline bool topicIs(const char *a, const char *b)
-    {
-        return a && b && strcmp(a, b) == 0;
-    }
-    static String toString(const byte *payload, unsigned int len)
-    {
-        String s;
-        s.reserve(len);
-        for (unsigned int i = 0; i < len; ++i)
-            s += (char)payload[i];
-        return s;
-    }
-    static String lower(const String &in)
-    {
-        String s = in;
-        s.toLowerCase();
-        return s;
-    }
+    Reason dispatch_(uint8_t cmd, const Envelope &env);
+    void acknowledge_(const char *topic, const Envelope &env, Reason r, uint64_t rxUs, uint64_t actUs);
+    void publishLatency_();
 
     // Deps
-    PubSubClient *mqtt = nullptr;
+    MqttManager *mqtt = nullptr;
     AutoModeManager *autoMode = nullptr;
     FeederManager *feeder = nullptr;
     LightManager *lights = nullptr;
+    CurrentSensorManager *currents = nullptr;
+    TempSensorManager *temps = nullptr;
+
+    LatencyWindow lat;
+    uint32_t nacks = 0;
 
     // Active instance pointer (one router)
     static MqttCommandRouter *self;
@@ -1,62 +1,241 @@
 #include "mqtt_manager.h"
 #include "mqtt_command_router.h"
+#include "esp_timer.h"  // esp_timer_get_time
+#include "esp_system.h" // esp_random
 
-void MqttManager::begin(const char *server, int port)
+MqttManager *MqttManager::self = nullptr;
+
+void MqttManager::begin(const DeviceConfig &dev,
+                        BaseType_t core,
+                        UBaseType_t priority,
+                        uint32_t stackBytes)
 {
-    client.setServer(server, port);
+    if (handle)
+        return;
+    self = this;
+    device = &dev;
+    rootLen = dev.rootLen();
+
+    client.setServer(dev.host, dev.port);
+    client.setBufferSize(FULL_TOPIC_MAX + PAYLOAD_MAX + 8); // header + root + topic + largest payload
+    client.setCallback(&MqttManager::onMessage_);
+    client.setSocketTimeout(CONNACK_TIMEOUT_S);
+    wifiClient.setTimeout(TCP_TIMEOUT_S);
+    link.seed(esp_random()); // per-device jitter
+
+    outboxLock = xSemaphoreCreateMutex();
+    inbox = xQueueCreate(INBOX_DEPTH, sizeof(Inbound));
+    if (!outboxLock || !inbox ||
+        xTaskCreatePinnedToCore(&MqttManager::entry_, "mqtt", stackBytes,
+                                this, priority, &handle, core) != pdPASS)
+    {
+        handle = nullptr;
+        Serial.println(F("[MQTT] task create failed; MQTT disabled"));
+    }
 }
 
 void MqttManager::setCallback(MQTT_CALLBACK_SIGNATURE)
 {
-    client.setCallback(callback);
+    this->callback = callback;
 }
 
+// ---------- loop() side ----------
+
 void MqttManager::loop()
 {
-    if (client.connected())
+    // Connect event first, so subscriptions/snapshots queue before inbound traffic
+    const uint32_t gen = connectGen;
+    if (gen != connectSeen)
     {
-        client.loop();
+        connectSeen = gen;
+        if (onReconnectSuccess)
+            onReconnectSuccess();
     }
+
+    if (!inbox)
+        return;
+    Inbound in;
+    while (xQueueReceive(inbox, &in, 0) == pdTRUE)
+    {
+        rxUs = in.rxUs;
+        if (callback)
+            callback(in.m.topic, in.m.payload, in.m.length);
+    }
+
+    // One wake per tick: whatever the previous tick queued goes out as a batch
+    if (handle && !outbox.empty())
+        xTaskNotifyGive(handle);
 }
 
-void MqttManager::reconnectIfNeeded()
+bool MqttManager::publish(const char *topic, const char *payload, bool retained)
 {
-    if (client.connected())
-        return;
+    return publish(topic, reinterpret_cast<const uint8_t *>(payload), payload ? strlen(payload) : 0, retained);
+}
+
+bool MqttManager::publish(const char *topic, const uint8_t *payload, unsigned int length, bool retained)
+{
+    if (!linkUp)
+        return false; // like PubSubClient: offline publishes fail, callers keep their state
+    return enqueue_(Kind::Publish, topic, payload, length, retained);
+}
+
+bool MqttManager::subscribe(const char *topic)
+{
+    return enqueue_(Kind::Subscribe, topic, nullptr, 0, false);
+}
+
+bool MqttManager::enqueue_(Kind kind, const char *topic, const uint8_t *payload, unsigned int length, bool retained)
+{
+    if (!handle || !topic)
+        return false;
+    // No notify here: loop() kicks the task once per tick, so values
+    // superseded within the tick are merged instead of sent
+    xSemaphoreTake(outboxLock, portMAX_DELAY);
+    const PublishQueue::Result r = outbox.push(kind, topic, payload, length, retained);
+    xSemaphoreGive(outboxLock);
+    return r != PublishQueue::Result::Dropped;
+}
+
+// ---------- network task ----------
+
+// static
+void MqttManager::entry_(void *arg)
+{
+    static_cast<MqttManager *>(arg)->run_();
+}
 
-    unsigned long now = millis();
-    if (now - lastReconnectAttempt >= reconnectInterval)
+// static: runs inside client.loop() on the network task
+void MqttManager::onMessage_(char *topic, uint8_t *payload, unsigned int length)
+{
+    if (!self)
+        return;
+    const uint64_t rxUs = esp_timer_get_time(); // before any queueing: acks report from here
+    // Device scope: strip our root, drop anything else
+    if (strncmp(topic, self->device->root, self->rootLen) != 0)
     {
-        lastReconnectAttempt = now;
+        ++self->droppedIn;
+        return;
+    }
+    topic += self->rootLen;
 
-        Serial.print("[MQTT] Attempting to connect...");
+    Inbound in;
+    const size_t topicLen = strlen(topic);
+    if (topicLen >= TOPIC_MAX || length > PAYLOAD_MAX)
+    {
+        ++self->droppedIn;
+        return;
+    }
+    in.rxUs = rxUs;
+    in.m.kind = Kind::Publish;
+    in.m.retained = false;
+    in.m.length = uint16_t(length);
+    memcpy(in.m.topic, topic, topicLen + 1);
+    memcpy(in.m.payload, payload, length);
+    if (xQueueSend(self->inbox, &in, 0) != pdTRUE)
+        ++self->droppedIn;
+}
 
-        if (client.connect("Esp32_Client"))
+void MqttManager::run_()
+{
+    using Wifi = LinkSupervisor::Wifi;
+    for (;;)
+    {
+        const int ws = WiFi.status();
+        const Wifi wifi = ws == WL_CONNECTED                                  ? Wifi::Up
+                          : ws == WL_NO_SSID_AVAIL || ws == WL_CONNECT_FAILED ? Wifi::Failed
+                                                                              : Wifi::Down;
+        const bool up = wifi == Wifi::Up && client.connected();
+        if (!up)
         {
-            Serial.println("connected");
+            linkUp = false;
+            if (wifi != Wifi::Up && client.state() == MQTT_CONNECTED)
+                client.disconnect(); // stale session: connect() would think it is still up
+        }
 
-            if (onReconnectSuccess)
-            {
-                onReconnectSuccess();
-            }
+        switch (link.poll(millis(), wifi, up ? MQTT_CONNECTED : client.state()))
+        {
+        case LinkSupervisor::Action::WifiConnect:
+            Serial.println(F("[WiFi] Reconnecting..."));
+            WiFi.reconnect(); // returns at once; the result shows up in WiFi.status()
+            break;
+        case LinkSupervisor::Action::WifiAbort:
+            Serial.println(F("[WiFi] Attempt timed out, backing off"));
+            WiFi.disconnect();
+            break;
+        case LinkSupervisor::Action::MqttConnect:
+            link.mqttResult(connect_(), millis());
+            break;
+        default:
+            break;
         }
-        else
+
+        if (!linkUp)
         {
-            Serial.print(" failed, rc=");
-            Serial.print(client.state());
-            Serial.println(" — will retry");
+            vTaskDelay(pdMS_TO_TICKS(50));
+            continue;
         }
 
-        delay(5); // short delay to avoid spam
+        client.loop(); // keepalive + inbound → inbox
+        drainOutbox_();
+
+        // Sleep until loop() queues something, or the keepalive poll is due
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(IDLE_WAKE_MS));
     }
 }
 
-bool MqttManager::isConnected()
+bool MqttManager::connect_()
 {
-    return client.connected();
+    Serial.print("[MQTT] Attempting to connect...");
+
+    // Blocks this task only, for at most TCP_TIMEOUT_S + CONNACK_TIMEOUT_S
+    const char *user = device->user[0] ? device->user : nullptr;
+    const char *pass = device->pass[0] ? device->pass : nullptr;
+    if (!client.connect(device->id, user, pass))
+    {
+        Serial.print(" failed, rc=");
+        Serial.print(client.state());
+        Serial.println(" — backing off");
+        return false;
+    }
+    Serial.println("connected");
+
+    // Anything queued while the link was down is stale (or a subscribe
+    // that onReconnectSuccess will repeat)
+    xSemaphoreTake(outboxLock, portMAX_DELAY);
+    outbox.clear();
+    xSemaphoreGive(outboxLock);
+    linkUp = true;
+    ++connectGen; // loop() raises onReconnectSuccess
+    return true;
 }
 
-PubSubClient &MqttManager::getClient()
+void MqttManager::drainOutbox_()
 {
-    return client;
-}
\ No newline at end of file
+    Message m;
+    char full[FULL_TOPIC_MAX];
+    memcpy(full, device->root, rootLen); // relative topics are appended per message
+    for (size_t n = 0; n < DRAIN_PER_PASS; ++n)
+    {
+        // Copy out under the lock, send without it: loop() never waits on the socket
+        xSemaphoreTake(outboxLock, portMAX_DELAY);
+        const bool have = outbox.pop(m);
+        xSemaphoreGive(outboxLock);
+        if (!have)
+            return;
+
+        memcpy(full + rootLen, m.topic, strlen(m.topic) + 1);
+        bool ok;
+        if (m.kind == Kind::Subscribe)
+            ok = client.subscribe(full);
+        else
+            ok = client.publish(full, m.payload, m.length, m.retained);
+        if (!ok)
+            ++droppedOut;
+        if (!client.connected())
+        {
+            linkUp = false;
+            return;
+        }
+    }
+    // Budget spent: the rest goes on the next wake (loop() kick or idle poll)
+}
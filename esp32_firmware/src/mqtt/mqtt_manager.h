@@ -5,18 +5,72 @@
 #include <PubSubClient.h>
 #include <functional>
 #include <WiFi.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include "mqtt/publish_queue.h"
+#include "mqtt/device_config.h"
+#include "wifi/link_supervisor.h"
 
+// MQTT transport. PubSubClient is owned by a network task: connect (with its
+// TCP timeout), keepalive, subscribe and the actual socket writes all happen
+// there. loop() side only touches queues:
+//  - publish()/subscribe() copy into the outbox (no socket I/O). The outbox is
+//    latest-value-wins per retained topic, so a burst inside one loop() tick
+//    (turnOnBoth, the reconnect snapshot) collapses to one message per topic
+//  - loop() kicks the task once per tick; it sends at most DRAIN_PER_PASS
+//    messages per wake, the rest wait for the next wake
+//  - inbound messages land in the inbox; loop() hands them to the callback,
+//    so command handlers still run on the loop thread
+//  - connect events are raised from loop() too (onReconnectSuccess)
+//  - the task is also the only place that reconnects: Wi-Fi and broker,
+//    paced by a LinkSupervisor (jittered backoff, bounded attempts, broker
+//    retried as soon as an IP is back). WiFiManager only reports events.
+//
+// Topics are relative to the device's root (DeviceConfig::root). The network
+// task puts the root in front when it sends or subscribes and strips it from
+// inbound topics; anything outside the root is dropped. Callers and the
+// command router only ever see relative topics.
 class MqttManager
 {
 public:
-    void begin(const char *server, int port);
+    static constexpr size_t TOPIC_MAX = PublishQueue::TOPIC_MAX; // relative, incl. NUL
+    static constexpr size_t FULL_TOPIC_MAX = DeviceConfig::ROOT_MAX - 1 + TOPIC_MAX;
+    static constexpr size_t PAYLOAD_MAX = PublishQueue::PAYLOAD_MAX;
+    static constexpr UBaseType_t INBOX_DEPTH = 8;
+
+    // Starts the network task (core 1, above loop() priority; it sleeps on the outbox).
+    // `device` must outlive the manager (PubSubClient keeps the host pointer).
+    void begin(const DeviceConfig &device,
+               BaseType_t core = 1,
+               UBaseType_t priority = 2,
+               uint32_t stackBytes = 6144);
     void setCallback(MQTT_CALLBACK_SIGNATURE);
+
+    // loop(): drain the inbox, raise connect events, kick the outbox. Never blocks.
     void loop();
-    void subscribe(const char *topic);
-    bool isConnected();
-    void reconnectIfNeeded();
-    PubSubClient &getClient();
-    void subscribeToTopics();
+
+    // Queued (or merged into a pending value for the same retained topic);
+    // false when offline, oversized or the outbox is full (caller may retry)
+    bool publish(const char *topic, const char *payload, bool retained = false);
+    bool publish(const char *topic, const uint8_t *payload, unsigned int length, bool retained = false);
+    bool subscribe(const char *topic);
+
+    // esp_timer time (µs) at which the network task took in the message now
+    // being handed to the callback; valid inside the callback only
+    uint64_t receivedUs() const { return rxUs; }
+
+    const char *getRoot() const { return device ? device->root : ""; }
+    const char *getClientId() const { return device ? device->id : ""; }
+
+    bool isConnected() const { return linkUp; }
+    bool connected() const { return linkUp; }
+
+    // Counters (approximate, written by both sides)
+    uint32_t getDroppedOut() const { return droppedOut + outbox.droppedCount(); }
+    uint32_t getCoalesced() const { return outbox.coalescedCount(); }
+    uint32_t getDroppedIn() const { return droppedIn; }
+    uint32_t getConnectCount() const { return connectGen; }
+    const LinkSupervisor::Stats &getLinkStats() const { return link.stats(); }
 
     std::function<void()> onReconnectSuccess;
     void setOnReconnectSuccess(std::function<void()> callback)
@@ -25,11 +79,50 @@ public:
     }
 
 private:
+    using Kind = PublishQueue::Kind;
+    using Message = PublishQueue::Message;
+    struct Inbound // inbox entries are copied by value
+    {
+        uint64_t rxUs;
+        Message m;
+    };
+
+    const DeviceConfig *device = nullptr;
+    size_t rootLen = 0;
+
     WiFiClient wifiClient;
     PubSubClient client{wifiClient};
+    MQTT_CALLBACK_SIGNATURE = nullptr; // → `callback`, run from loop()
+
+    PublishQueue outbox;                  // guarded by outboxLock
+    SemaphoreHandle_t outboxLock = nullptr;
+    QueueHandle_t inbox = nullptr;
+    TaskHandle_t handle = nullptr;
+
+    // Task → loop
+    volatile bool linkUp = false;
+    volatile uint32_t connectGen = 0;
+    uint32_t connectSeen = 0;
+    uint64_t rxUs = 0; // of the message in the callback
+
+    volatile uint32_t droppedOut = 0;
+    volatile uint32_t droppedIn = 0;
+
+    LinkSupervisor link; // network task only
+    // Per broker attempt: TCP connect + CONNACK wait bound the blocking connect()
+    static constexpr uint16_t TCP_TIMEOUT_S = 2;
+    static constexpr uint16_t CONNACK_TIMEOUT_S = 3;
+    static constexpr uint32_t IDLE_WAKE_MS = 10;      // keepalive / inbound poll
+    static constexpr size_t DRAIN_PER_PASS = 16;      // outbox budget per wake
+
+    bool enqueue_(Kind kind, const char *topic, const uint8_t *payload, unsigned int length, bool retained);
 
-    const unsigned long reconnectInterval = 15000;
-    unsigned long lastReconnectAttempt = 0;
+    static MqttManager *self;
+    static void entry_(void *arg);
+    static void onMessage_(char *topic, uint8_t *payload, unsigned int length);
+    void run_();
+    bool connect_();
+    void drainOutbox_();
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,95 @@
+#include "mqtt/publish_queue.h"
+#include <string.h>
+
+uint32_t PublishQueue::hash_(const char *s, size_t len)
+{
+    // FNV-1a
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < len; ++i)
+    {
+        h ^= uint8_t(s[i]);
+        h *= 16777619u;
+    }
+    return h;
+}
+
+PublishQueue::Result PublishQueue::push(Kind kind, const char *topic, const uint8_t *payload, size_t length, bool retained)
+{
+    const size_t topicLen = topic ? strlen(topic) : TOPIC_MAX;
+    if (topicLen >= TOPIC_MAX || length > PAYLOAD_MAX || (length && !payload))
+    {
+        ++dropped;
+        return Result::Dropped;
+    }
+    const uint32_t th = hash_(topic, topicLen);
+
+    // Latest value wins: only retained state, never events or subscribes
+    if (kind == Kind::Publish && retained)
+    {
+        for (Slot &s : slots)
+        {
+            if (s.used && s.msg.kind == Kind::Publish && s.msg.retained &&
+                s.topicHash == th && strcmp(s.msg.topic, topic) == 0)
+            {
+                s.msg.length = uint16_t(length);
+                if (length)
+                    memcpy(s.msg.payload, payload, length);
+                ++coalesced;
+                return Result::Coalesced;
+            }
+        }
+    }
+
+    if (count >= DEPTH)
+    {
+        ++dropped;
+        return Result::Dropped;
+    }
+    for (Slot &s : slots)
+    {
+        if (s.used)
+            continue;
+        s.used = true;
+        s.seq = nextSeq++;
+        s.topicHash = th;
+        s.msg.kind = kind;
+        s.msg.retained = retained;
+        s.msg.length = uint16_t(length);
+        memcpy(s.msg.topic, topic, topicLen + 1);
+        if (length)
+            memcpy(s.msg.payload, payload, length);
+        ++count;
+        return Result::Queued;
+    }
+    ++dropped; // unreachable while count is consistent
+    return Result::Dropped;
+}
+
+bool PublishQueue::pop(Message &out)
+{
+    Slot *oldest = nullptr;
+    for (Slot &s : slots)
+    {
+        // Wrap-safe "earlier than"
+        if (s.used && (!oldest || int32_t(s.seq - oldest->seq) < 0))
+            oldest = &s;
+    }
+    if (!oldest)
+        return false;
+
+    out.kind = oldest->msg.kind;
+    out.retained = oldest->msg.retained;
+    out.length = oldest->msg.length;
+    memcpy(out.topic, oldest->msg.topic, strlen(oldest->msg.topic) + 1);
+    memcpy(out.payload, oldest->msg.payload, oldest->msg.length);
+    oldest->used = false;
+    --count;
+    return true;
+}
+
+void PublishQueue::clear()
+{
+    for (Slot &s : slots)
+        s.used = false;
+    count = 0;
+}
@@ -0,0 +1,77 @@
+#ifndef PUBLISH_QUEUE_H
+#define PUBLISH_QUEUE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Bounded outbound MQTT queue, latest value wins. Host-buildable, not
+// thread-safe on its own (MqttManager wraps it in a mutex).
+//
+//  - A retained publish to a topic that is still queued overwrites that
+//    entry's payload in place: the broker only ever gets the newest value, and
+//    the entry keeps its place in line so a busy topic can't starve others.
+//  - Non-retained publishes (events: capture chunks, command replies) and
+//    subscribes are never merged; they go out in order.
+//  - Full queue: the new message is rejected and counted. Callers see false
+//    and retry (TelemetryPublisher does not record a failed send).
+class PublishQueue
+{
+public:
+    static constexpr size_t TOPIC_MAX = 64; // incl. NUL
+    static constexpr size_t PAYLOAD_MAX = 256;
+    static constexpr size_t DEPTH = 48; // > one reconnect snapshot (~45 topics)
+
+    enum class Kind : uint8_t
+    {
+        Publish,
+        Subscribe
+    };
+
+    enum class Result : uint8_t
+    {
+        Queued,
+        Coalesced, // replaced a pending value for the same topic
+        Dropped    // full, or topic/payload too long
+    };
+
+    struct Message
+    {
+        Kind kind;
+        bool retained;
+        uint16_t length;
+        char topic[TOPIC_MAX];
+        uint8_t payload[PAYLOAD_MAX];
+    };
+
+    Result push(Kind kind, const char *topic, const uint8_t *payload, size_t length, bool retained);
+    // Oldest pending message (by first enqueue); false when empty
+    bool pop(Message &out);
+    void clear();
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    // Counters since boot
+    uint32_t coalescedCount() const { return coalesced; }
+    uint32_t droppedCount() const { return dropped; }
+
+private:
+    struct Slot
+    {
+        bool used = false;
+        uint32_t seq = 0;
+        uint32_t topicHash = 0;
+        Message msg;
+    };
+
+    Slot slots[DEPTH];
+    size_t count = 0;
+    uint32_t nextSeq = 0;
+
+    uint32_t coalesced = 0;
+    uint32_t dropped = 0;
+
+    static uint32_t hash_(const char *s, size_t len);
+};
+
+#endif // PUBLISH_QUEUE_H
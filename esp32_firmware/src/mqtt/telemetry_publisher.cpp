@@ -0,0 +1,149 @@
+#include "mqtt/telemetry_publisher.h"
+#include "mqtt/mqtt_manager.h"
+#include <math.h>
+
+void TelemetryPublisher::begin(MqttManager &transport, uint32_t hbMs)
+{
+    mqtt = &transport;
+    heartbeatMs = hbMs;
+}
+
+bool TelemetryPublisher::connected() const
+{
+    return mqtt && mqtt->connected();
+}
+
+uint32_t TelemetryPublisher::coalescedCount() const
+{
+    return mqtt ? mqtt->getCoalesced() : 0;
+}
+
+uint32_t TelemetryPublisher::droppedCount() const
+{
+    return mqtt ? mqtt->getDroppedOut() : 0;
+}
+
+uint32_t TelemetryPublisher::hash_(const uint8_t *data, size_t len)
+{
+    // FNV-1a
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < len; ++i)
+    {
+        h ^= data[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+TelemetryPublisher::Entry *TelemetryPublisher::find_(const char *topic, bool create)
+{
+    const uint32_t th = hash_(reinterpret_cast<const uint8_t *>(topic), strlen(topic));
+    for (size_t i = 0; i < entryCount; ++i)
+    {
+        Entry &e = entries[i];
+        if (e.topic == topic || (e.topicHash == th && strcmp(e.topic, topic) == 0))
+            return &e;
+    }
+    if (!create || entryCount >= MAX_TOPICS)
+        return nullptr;
+
+    Entry &e = entries[entryCount++];
+    e = Entry();
+    e.topic = topic;
+    e.topicHash = th;
+    return &e;
+}
+
+bool TelemetryPublisher::heartbeatDue_(const Entry &e, uint32_t now) const
+{
+    const uint32_t hb = e.heartbeatMs ? e.heartbeatMs : heartbeatMs;
+    return now - e.sentMs >= hb;
+}
+
+bool TelemetryPublisher::send_(Entry *e, const char *topic, const uint8_t *payload, unsigned int length, bool retained)
+{
+    if (!mqtt)
+        return false;
+    if (!mqtt->publish(topic, payload, length, retained))
+        return false; // offline / outbox full, not recorded: next call retries
+    ++sent;
+    if (e)
+    {
+        e->payloadHash = hash_(payload, length);
+        e->payloadLen = uint16_t(length);
+        e->sentMs = millis();
+        e->valid = true;
+    }
+    return true;
+}
+
+bool TelemetryPublisher::publish(const char *topic, const uint8_t *payload, unsigned int length, bool retained)
+{
+    if (!topic)
+        return false;
+    if (!retained)
+        return send_(nullptr, topic, payload, length, false);
+
+    Entry *e = find_(topic, true);
+    if (!e)
+    {
+        ++untracked; // table full: behave like a plain client
+        return send_(nullptr, topic, payload, length, true);
+    }
+
+    if (e->valid && e->payloadLen == length && e->payloadHash == hash_(payload, length) &&
+        !heartbeatDue_(*e, millis()))
+    {
+        ++suppressed;
+        return true;
+    }
+    e->hasValue = false; // string topic: any deadband state is stale
+    return send_(e, topic, payload, length, true);
+}
+
+bool TelemetryPublisher::publish(const char *topic, const char *payload, bool retained)
+{
+    return publish(topic, reinterpret_cast<const uint8_t *>(payload), payload ? strlen(payload) : 0, retained);
+}
+
+bool TelemetryPublisher::publishIfMoved(const char *topic, const char *payload, float value, float deadband)
+{
+    if (!topic || !payload)
+        return false;
+    Entry *e = find_(topic, true);
+    if (!e)
+    {
+        ++untracked;
+        return send_(nullptr, topic, reinterpret_cast<const uint8_t *>(payload), strlen(payload), true);
+    }
+
+    if (e->valid && e->hasValue && fabsf(value - e->value) < deadband && !heartbeatDue_(*e, millis()))
+    {
+        ++suppressed;
+        return true;
+    }
+    if (!send_(e, topic, reinterpret_cast<const uint8_t *>(payload), strlen(payload), true))
+        return false;
+    e->value = value; // deadband is measured from what the broker holds
+    e->hasValue = true;
+    return true;
+}
+
+bool TelemetryPublisher::publishValue(const char *topic, float value, uint8_t decimals, float deadband)
+{
+    char buf[24];
+    snprintf(buf, sizeof(buf), "%.*f", decimals, value);
+    return publishIfMoved(topic, buf, value, deadband);
+}
+
+void TelemetryPublisher::setHeartbeat(const char *topic, uint32_t hbMs)
+{
+    if (Entry *e = find_(topic, true))
+        e->heartbeatMs = hbMs;
+}
+
+void TelemetryPublisher::invalidate()
+{
+    for (size_t i = 0; i < entryCount; ++i)
+        entries[i].valid = false;
+}
@@ -0,0 +1,85 @@
+#ifndef TELEMETRY_PUBLISHER_H
+#define TELEMETRY_PUBLISHER_H
+
+#include <Arduino.h>
+
+class MqttManager;
+
+// Publish-on-change layer in front of the MQTT transport. Every manager
+// publishes through one instance; same publish() shape as PubSubClient, so
+// call sites stay as they were.
+//
+//  - Retained publishes are tracked per topic (fixed table, no heap). A
+//    byte-identical payload is suppressed until the topic's heartbeat is due.
+//  - publishValue()/publishIfMoved() add a numeric deadband: small moves are
+//    suppressed too, the heartbeat still refreshes the value.
+//  - Non-retained publishes are events (capture chunks, command replies):
+//    always sent, never tracked.
+//  - A failed send is not recorded, so the next call retries it.
+//
+// Topic pointers are stored, not copied: pass string literals or member
+// buffers that live as long as the publisher (all topics in this tree do).
+class TelemetryPublisher
+{
+public:
+    static constexpr size_t MAX_TOPICS = 96;
+    static constexpr uint32_t DEFAULT_HEARTBEAT_MS = 120000;
+
+    void begin(MqttManager &transport, uint32_t heartbeatMs = DEFAULT_HEARTBEAT_MS);
+
+    bool publish(const char *topic, const char *payload, bool retained = false);
+    bool publish(const char *topic, const uint8_t *payload, unsigned int length, bool retained = false);
+
+    // Numeric telemetry: sent when |value - last sent| >= deadband, or on heartbeat
+    bool publishValue(const char *topic, float value, uint8_t decimals, float deadband);
+    // Same test on `value`, but the payload is caller-formatted (JSON etc.)
+    bool publishIfMoved(const char *topic, const char *payload, float value, float deadband);
+
+    // Per-topic heartbeat (0 = publisher default). Creates the entry if needed.
+    void setHeartbeat(const char *topic, uint32_t heartbeatMs);
+    void setDefaultHeartbeat(uint32_t ms) { heartbeatMs = ms; }
+
+    // Forget what the broker has seen (MQTT reconnect): the next publish of
+    // every topic goes out
+    void invalidate();
+
+    bool connected() const;
+
+    // Counters since boot
+    uint32_t sentCount() const { return sent; }
+    uint32_t suppressedCount() const { return suppressed; }
+    uint32_t untrackedCount() const { return untracked; }
+    // Transport outbox: values merged before sending, messages rejected
+    uint32_t coalescedCount() const;
+    uint32_t droppedCount() const;
+
+private:
+    struct Entry
+    {
+        const char *topic = nullptr;
+        uint32_t topicHash = 0;
+        uint32_t payloadHash = 0;
+        uint16_t payloadLen = 0;
+        bool valid = false; // broker has our last payload
+        bool hasValue = false;
+        float value = 0.0f;
+        uint32_t sentMs = 0;
+        uint32_t heartbeatMs = 0; // 0 = default
+    };
+
+    MqttManager *mqtt = nullptr;
+    uint32_t heartbeatMs = DEFAULT_HEARTBEAT_MS;
+    Entry entries[MAX_TOPICS];
+    size_t entryCount = 0;
+
+    uint32_t sent = 0;
+    uint32_t suppressed = 0;
+    uint32_t untracked = 0;
+
+    Entry *find_(const char *topic, bool create);
+    bool heartbeatDue_(const Entry &e, uint32_t now) const;
+    bool send_(Entry *e, const char *topic, const uint8_t *payload, unsigned int length, bool retained);
+    static uint32_t hash_(const uint8_t *data, size_t len);
+};
+
+#endif // TELEMETRY_PUBLISHER_H
@@ -19,12 +19,19 @@ void RtcManager::begin()
 
     syncFromNTP();
     currentTime = rtc.now();
-    lastSync = millis();
+    lastReadMs = lastSync = millis();
 }
 
 void RtcManager::update()
 {
-    currentTime = rtc.now();
+    // The bus is shared with the ADS1115s: read the chip once a second, not
+    // on every loop() pass
+    const unsigned long nowMs = millis();
+    if (nowMs - lastReadMs >= readInterval)
+    {
+        currentTime = rtc.now();
+        lastReadMs = nowMs;
+    }
 
     if (millis() - lastSync >= syncInterval)
     {
@@ -7,12 +7,14 @@ class RtcManager
 {
 public:
     void begin();
-    void update();            // Sync NTP every few hours
+    void update();            // Read the DS3231 once a second; sync NTP every few hours
     DateTime getTime() const; // Get latest RTC time
 
 private:
     RTC_DS3231 rtc;
     DateTime currentTime;
+    unsigned long lastReadMs = 0;
+    const unsigned long readInterval = 1000; // DS3231 has 1 s resolution anyway
 
     const char *ntpServer = "pool.ntp.org";
     const long gmtOffset_sec = -5 * 3600;
@@ -0,0 +1,89 @@
+#include "sampling/sampling_task.h"
+#include "current_sensor/current_sensor_manager.h"
+#include "Temp_sensor/temp_sensor_manager.h"
+
+bool SamplingTask::begin(CurrentSensorManager &currentsRef,
+                         TempSensorManager &tempsRef,
+                         BaseType_t core,
+                         UBaseType_t priority,
+                         uint32_t stackBytes)
+{
+    if (handle)
+        return true;
+
+    currents = &currentsRef;
+    temps = &tempsRef;
+
+    if (xTaskCreatePinnedToCore(&SamplingTask::entry_, "sampling", stackBytes,
+                                this, priority, &handle, core) != pdPASS)
+    {
+        handle = nullptr;
+        Serial.println(F("[Sampling] task create failed; acquiring from loop()"));
+        return false;
+    }
+
+    // From here on loop() is consumer-only. Wire's HAL lock serializes each
+    // I2C transaction, so the OLED/RTC on loop() can share the bus with the ADS.
+    currents->setAcquisitionTask(handle);
+
+    // OneWire below the RDY path; without the task loop() keeps running it
+    const UBaseType_t oneWirePriority = priority > 1 ? priority - 1 : 1;
+    if (xTaskCreatePinnedToCore(&SamplingTask::oneWireEntry_, "onewire", stackBytes,
+                                this, oneWirePriority, &oneWireHandle, core) != pdPASS)
+    {
+        oneWireHandle = nullptr;
+        Serial.println(F("[Sampling] onewire task create failed; DS18B20 reads stay on loop()"));
+        return true;
+    }
+    temps->setExternalAcquisition(true);
+    return true;
+}
+
+uint32_t SamplingTask::getOverruns() const
+{
+    return currents ? currents->getAdsOverruns() : 0;
+}
+
+// static
+void SamplingTask::entry_(void *arg)
+{
+    static_cast<SamplingTask *>(arg)->run_();
+}
+
+// static
+void SamplingTask::oneWireEntry_(void *arg)
+{
+    static_cast<SamplingTask *>(arg)->runOneWire_();
+}
+
+void SamplingTask::run_()
+{
+    for (;;)
+    {
+        // RDY edge (or the idle timeout) → service everything once
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(IDLE_WAKE_MS));
+
+        const uint32_t t0 = micros();
+        currents->acquire();
+        const uint32_t busy = micros() - t0;
+
+        ++wakeCount;
+        if (busy > maxBusyUs)
+            maxBusyUs = busy;
+    }
+}
+
+void SamplingTask::runOneWire_()
+{
+    for (;;)
+    {
+        // Wall time, so preemption by the sampling task is included
+        const uint32_t t0 = micros();
+        temps->acquire();
+        const uint32_t busy = micros() - t0;
+        if (busy > oneWireMaxBusyUs)
+            oneWireMaxBusyUs = busy;
+
+        vTaskDelay(pdMS_TO_TICKS(ONEWIRE_TICK_MS));
+    }
+}
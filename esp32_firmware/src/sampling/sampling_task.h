@@ -0,0 +1,62 @@
+#ifndef SAMPLING_TASK_H
+#define SAMPLING_TASK_H
+
+#include <Arduino.h>
+
+// Forward declares to keep the header light
+class CurrentSensorManager;
+class TempSensorManager;
+
+// Sensor acquisition on its own pinned FreeRTOS tasks.
+// The ADS1115 RDY interrupt wakes the sampling task, which reads the
+// conversion and pushes timestamped samples into lock-free SPSC rings; loop()
+// only drains them in the managers that publish.
+// OneWire runs on a second task one priority lower on the same core: an
+// addressed DS18B20 read is ~10 ms of bus traffic (bit-bang backend), which
+// would miss ~8 RDY edges at 860 SPS and cut the RMS window with a gap. The
+// sampling task preempts it between bit slots instead.
+class SamplingTask
+{
+public:
+    SamplingTask() = default;
+
+    // Call after the managers' begin(); hands their producer side to the tasks.
+    // The OneWire task runs at priority - 1 (at least 1).
+    bool begin(CurrentSensorManager &currents,
+               TempSensorManager &temps,
+               BaseType_t core = 0,
+               UBaseType_t priority = 3,
+               uint32_t stackBytes = 4096);
+
+    bool isRunning() const { return handle != nullptr; }
+
+    // Health (read from loop(); approximate, written by the tasks)
+    uint32_t getWakeCount() const { return wakeCount; }
+    uint32_t getMaxBusyUs() const { return maxBusyUs; }
+    uint32_t getOneWireMaxBusyUs() const { return oneWireMaxBusyUs; }
+    // RDY edges the sampling task did not read in time, all chips
+    uint32_t getOverruns() const;
+    void resetMaxBusy() { maxBusyUs = oneWireMaxBusyUs = 0; }
+
+private:
+    // Wake at least this often even without RDY edges (a chip that stopped)
+    static constexpr uint32_t IDLE_WAKE_MS = 10;
+    // OneWire state machine step: one phase check or one probe read per tick
+    static constexpr uint32_t ONEWIRE_TICK_MS = 5;
+
+    CurrentSensorManager *currents = nullptr;
+    TempSensorManager *temps = nullptr;
+    TaskHandle_t handle = nullptr;
+    TaskHandle_t oneWireHandle = nullptr;
+
+    volatile uint32_t wakeCount = 0;
+    volatile uint32_t maxBusyUs = 0;
+    volatile uint32_t oneWireMaxBusyUs = 0;
+
+    static void entry_(void *arg);
+    static void oneWireEntry_(void *arg);
+    void run_();
+    void runOneWire_();
+};
+
+#endif // SAMPLING_TASK_H
@@ -0,0 +1,74 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+
+// Lock-free single-producer / single-consumer ring (no heap, no locks).
+// Exactly one context may call push() and exactly one may call pop()/drain();
+// they may run on different cores. N must be a power of two; capacity is N - 1.
+template <typename T, size_t N>
+class SpscRing
+{
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscRing size must be a power of two");
+
+public:
+    // Producer side; returns false (and drops the item) when full
+    bool push(const T &item)
+    {
+        const uint32_t h = head.load(std::memory_order_relaxed);
+        const uint32_t next = (h + 1) & MASK;
+        if (next == tail.load(std::memory_order_acquire))
+            return false;
+        buf[h] = item;
+        head.store(next, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side; returns false when empty
+    bool pop(T &out)
+    {
+        const uint32_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire))
+            return false;
+        out = buf[t];
+        tail.store((t + 1) & MASK, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side; pops up to maxCount items, returns how many were copied
+    size_t drain(T *out, size_t maxCount)
+    {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        const uint32_t h = head.load(std::memory_order_acquire);
+        size_t n = 0;
+        while (n < maxCount && t != h)
+        {
+            out[n++] = buf[t];
+            t = (t + 1) & MASK;
+        }
+        tail.store(t, std::memory_order_release);
+        return n;
+    }
+
+    // Consumer side; drops everything queued so far
+    void clear() { tail.store(head.load(std::memory_order_acquire), std::memory_order_release); }
+
+    // Approximate when called from the other side
+    size_t size() const
+    {
+        return (head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire)) & MASK;
+    }
+    bool empty() const { return size() == 0; }
+    static constexpr size_t capacity() { return N - 1; }
+
+private:
+    static constexpr uint32_t MASK = N - 1;
+
+    T buf[N];
+    std::atomic<uint32_t> head{0}; // written by producer
+    std::atomic<uint32_t> tail{0}; // written by consumer
+};
+
+#endif // SPSC_RING_H
@@ -0,0 +1,92 @@
+#include "frame_publisher.h"
+
+#include "esp_system.h" // esp_get_free_heap_size
+#include "esp_timer.h"  // esp_timer_get_time
+#include "mqtt/mqtt_manager.h"
+#include "mqtt/telemetry_publisher.h"
+#include "auto_mode/auto_mode_manager.h"
+#include "feeder/feeder_manager.h"
+#include "lights/light_manager.h"
+#include "Temp_sensor/temp_sensor_manager.h"
+#include "current_sensor/current_sensor_manager.h"
+#include "telemetry_frame.h"
+#include "topics.h"
+
+static_assert(TEMP_PROBE_COUNT <= TELEMETRY_FRAME_MAX_TEMPS, "telemetry frame: too many probes");
+static_assert(CURRENT_CHANNEL_COUNT <= TELEMETRY_FRAME_MAX_CURRENTS, "telemetry frame: too many CT channels");
+static_assert(TELEMETRY_FRAME_MAX <= MqttManager::PAYLOAD_MAX, "telemetry frame exceeds the MQTT payload buffer");
+
+FramePublisher::FramePublisher(LightManager &lights,
+                               FeederManager &feeder,
+                               AutoModeManager &autoMode,
+                               TempSensorManager &temps,
+                               CurrentSensorManager &currents,
+                               TelemetryPublisher &telemetry)
+    : lights_(lights),
+      feeder_(feeder),
+      autoMode_(autoMode),
+      temps_(temps),
+      currents_(currents),
+      mqtt_(telemetry) {}
+
+void FramePublisher::update(uint32_t rtcSeconds)
+{
+    if (!intervalMs_)
+        return;
+    const uint32_t now = millis();
+    if ((uint32_t)(now - lastTick_) < intervalMs_)
+        return;
+    lastTick_ = now;
+    publishNow(rtcSeconds);
+}
+
+void FramePublisher::publishNow(uint32_t rtcSeconds)
+{
+    if (!intervalMs_ || !mqtt_.connected())
+        return;
+
+    TelemetryFrame f;
+    f.flags = (lights_.isOn() ? TF_LIGHTS : 0) |
+              (lights_.isHeatOn() ? TF_HEAT : 0) |
+              (lights_.isUVOn() ? TF_UV : 0) |
+              (autoMode_.isEnabled() ? TF_AUTO_MODE : 0) |
+              (feeder_.isRunning() ? TF_FEEDER_RUNNING : 0) |
+              (lights_.isThermostatEnabled() ? TF_THERMOSTAT : 0);
+    f.seq = seq_;
+    f.rtcSeconds = rtcSeconds;
+    f.uptimeS = uint32_t(esp_timer_get_time() / 1000000ULL);
+    const size_t heapKB = esp_get_free_heap_size() / 1024;
+    f.heapKB = heapKB > 0xFFFF ? 0xFFFF : uint16_t(heapKB);
+    f.feedCount = uint16_t(feeder_.getFeedCount());
+    if (lights_.isThermostatEnabled())
+        f.heatDutyPct = uint8_t(lights_.thermostat().duty() * 100.0f + 0.5f);
+
+    f.tempCount = uint8_t(TEMP_PROBE_COUNT);
+    for (size_t i = 0; i < TEMP_PROBE_COUNT; ++i)
+    {
+        TelemetryFrameTemp &t = f.temps[i];
+        if (!temps_.isPresent(i))
+            continue; // zeros, no TFT_PRESENT
+        t.tempF = temps_.getTempFf(i);
+        t.slopeFPerMin = temps_.getSlopeFPerMin(i);
+        t.flags = TFT_PRESENT |
+                  (temps_.isOutlier(i) ? TFT_OUTLIER : 0) |
+                  (temps_.isRiseAlarm(i) ? TFT_RISE_ALARM : 0);
+    }
+
+    f.currentCount = uint8_t(CURRENT_CHANNEL_COUNT);
+    for (size_t ch = 0; ch < CURRENT_CHANNEL_COUNT; ++ch)
+    {
+        TelemetryFrameCurrent &c = f.currents[ch];
+        c.amps = currents_.lastA(ch);
+        c.energyWh = float(currents_.energyWh(ch));
+        c.health = uint8_t(currents_.health(ch));
+        c.flags = (currents_.isPowered(ch) ? TFC_POWERED : 0) |
+                  (c.amps > currents_.thresholdA(ch) ? TFC_ABOVE_THRESHOLD : 0);
+    }
+
+    uint8_t buf[TELEMETRY_FRAME_MAX];
+    const size_t len = telemetryEncodeFrame(f, buf);
+    if (len && mqtt_.publish(TOPIC_TELEMETRY_FRAME, buf, len, true))
+        ++seq_; // a gap in seq = a frame the broker never got
+}
@@ -0,0 +1,51 @@
+#ifndef FRAME_PUBLISHER_H
+#define FRAME_PUBLISHER_H
+
+#include <Arduino.h>
+
+class LightManager;
+class FeederManager;
+class AutoModeManager;
+class TempSensorManager;
+class CurrentSensorManager;
+class TelemetryPublisher;
+
+// Packed telemetry frame (include/telemetry_frame.h) on TOPIC_TELEMETRY_FRAME:
+// every sensor and status field in one retained binary message per cycle,
+// next to the per-value topics. A dashboard that subscribes gets the whole
+// picture from a single retained message.
+class FramePublisher
+{
+public:
+    FramePublisher(LightManager &lights,
+                   FeederManager &feeder,
+                   AutoModeManager &autoMode,
+                   TempSensorManager &temps,
+                   CurrentSensorManager &currents,
+                   TelemetryPublisher &telemetry);
+
+    // 0 = off (the frame is optional)
+    void begin(uint32_t intervalMs = 5000) { intervalMs_ = intervalMs; }
+
+    // Call from loop() with the RTC time (DateTime::unixtime())
+    void update(uint32_t rtcSeconds);
+
+    // e.g. after MQTT reconnect
+    void publishNow(uint32_t rtcSeconds);
+
+    uint32_t getSeq() const { return seq_; }
+
+private:
+    LightManager &lights_;
+    FeederManager &feeder_;
+    AutoModeManager &autoMode_;
+    TempSensorManager &temps_;
+    CurrentSensorManager &currents_;
+    TelemetryPublisher &mqtt_;
+
+    uint32_t intervalMs_ = 0;
+    uint32_t lastTick_ = 0;
+    uint32_t seq_ = 0;
+};
+
+#endif
@@ -4,37 +4,40 @@
 #include "esp_system.h" // esp_get_free_heap_size
 #include "esp_timer.h"  // esp_timer_get_time
 #include "wifi/wifi_manager.h"
+#include "mqtt/telemetry_publisher.h"
 #include "mqtt/mqtt_manager.h"
 #include "auto_mode/auto_mode_manager.h"
 #include "feeder/feeder_manager.h"
 #include "lights/light_manager.h"
+#include "sampling/sampling_task.h"
 #include "topics.h"
 
 StatusPublisher::StatusPublisher(LightManager &lights,
                                  FeederManager &feeder,
                                  AutoModeManager &autoMode,
-                                 MqttManager &mqtt)
+                                 TelemetryPublisher &telemetry)
     : lights_(lights),
       feeder_(feeder),
       autoMode_(autoMode),
-      mqtt_(mqtt) {}
+      mqtt_(telemetry) {}
 
 void StatusPublisher::begin(uint32_t intervalMs)
 {
     intervalMs_ = intervalMs;
     lastTick_ = millis();
-    prevMqttConnected_ = mqtt_.getClient().connected();
+    prevMqttConnected_ = mqtt_.connected();
     if (prevMqttConnected_)
         publishAll_(); // initial snapshot if online
 }
 
 void StatusPublisher::update()
 {
-    bool nowConn = mqtt_.getClient().connected();
+    bool nowConn = mqtt_.connected();
 
     // Immediate publish after reconnect
     if (nowConn && !prevMqttConnected_)
     {
+        mqtt_.invalidate(); // broker may have lost retained state
         publishAll_();
         lastTick_ = millis();
     }
@@ -55,7 +58,7 @@ void StatusPublisher::publishNow()
 
 void StatusPublisher::publishAll_()
 {
-    auto &client = mqtt_.getClient();
+    auto &client = mqtt_;
     if (!client.connected())
         return;
 
@@ -96,13 +99,53 @@ void StatusPublisher::publishAll_()
     {
         size_t heapBytes = esp_get_free_heap_size();
         String heapStr = String(heapBytes / 1024) + " KB";
-        client.publish(TOPIC_ESP_HEAP, heapStr.c_str(), R_HEAP);
+        client.publishIfMoved(TOPIC_ESP_HEAP, heapStr.c_str(), float(heapBytes / 1024), HEAP_DEADBAND_KB);
     }
 
     // Uptime (ms)
     {
         uint64_t uptime_ms = esp_timer_get_time() / 1000ULL;
         String upStr = String((unsigned long long)uptime_ms);
-        client.publish(TOPIC_ESP_UPTIME, upStr.c_str(), R_UPTIME);
+        client.publishIfMoved(TOPIC_ESP_UPTIME, upStr.c_str(), float(uptime_ms), UPTIME_STEP_MS);
+    }
+
+    // Telemetry layer counters
+    {
+        char buf[112];
+        snprintf(buf, sizeof(buf), "{\"sent\":%lu,\"suppressed\":%lu,\"coalesced\":%lu,\"dropped\":%lu}",
+                 (unsigned long)client.sentCount(), (unsigned long)client.suppressedCount(),
+                 (unsigned long)client.coalescedCount(), (unsigned long)client.droppedCount());
+        client.publishIfMoved(TOPIC_ESP_TELEMETRY, buf, float(client.sentCount()), TELEMETRY_STEP);
+    }
+
+    // Reconnect supervisor: drops by cause, attempts, time to reconnect
+    if (link_ && wifi_)
+    {
+        const LinkSupervisor::Stats &ls = link_->getLinkStats();
+        const WiFiManager::DisconnectCounts &wd = wifi_->disconnects();
+        char buf[256];
+        const int n = snprintf(buf, sizeof(buf),
+                               "{\"wifi_drops\":%lu,\"wifi_attempts\":%lu,\"wifi_fail\":%lu,"
+                               "\"beacon\":%lu,\"no_ap\":%lu,\"auth\":%lu,\"other\":%lu,"
+                               "\"mqtt_drops\":%lu,\"keepalive\":%lu,\"lost\":%lu,"
+                               "\"mqtt_attempts\":%lu,\"mqtt_fail\":%lu,\"ttr_ms\":%lu,\"ttr_max_ms\":%lu}",
+                               (unsigned long)ls.wifiDrops, (unsigned long)ls.wifiAttempts, (unsigned long)ls.wifiFailures,
+                               (unsigned long)wd.beaconTimeout, (unsigned long)wd.noApFound,
+                               (unsigned long)wd.authFail, (unsigned long)wd.other,
+                               (unsigned long)ls.mqttDrops, (unsigned long)ls.mqttKeepalive, (unsigned long)ls.mqttLost,
+                               (unsigned long)ls.mqttAttempts, (unsigned long)ls.mqttFailures,
+                               (unsigned long)ls.lastReconnectMs, (unsigned long)ls.maxReconnectMs);
+        if (n > 0 && size_t(n) < sizeof(buf))
+            client.publish(TOPIC_ESP_LINK, buf, true);
+    }
+
+    // Acquisition tasks: RDY edges missed by the sampling task show up here
+    if (sampler_)
+    {
+        char buf[112];
+        snprintf(buf, sizeof(buf), "{\"wakes\":%lu,\"max_busy_us\":%lu,\"onewire_max_us\":%lu,\"overruns\":%lu}",
+                 (unsigned long)sampler_->getWakeCount(), (unsigned long)sampler_->getMaxBusyUs(),
+                 (unsigned long)sampler_->getOneWireMaxBusyUs(), (unsigned long)sampler_->getOverruns());
+        client.publishIfMoved(TOPIC_ESP_SAMPLING, buf, float(sampler_->getOverruns()), OVERRUN_STEP);
     }
 }
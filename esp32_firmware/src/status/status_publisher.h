@@ -8,7 +8,10 @@
 class LightManager;
 class FeederManager;
 class AutoModeManager;
+class TelemetryPublisher;
 class MqttManager;
+class WiFiManager;
+class SamplingTask;
 
 class StatusPublisher
 {
@@ -16,9 +19,11 @@ public:
     StatusPublisher(LightManager &lights,
                     FeederManager &feeder,
                     AutoModeManager &autoMode,
-                    MqttManager &mqtt);
+                    TelemetryPublisher &telemetry);
 
-    // Set cadence and push an initial snapshot if already connected
+    // Set cadence and push an initial snapshot if already connected.
+    // Unchanged values are suppressed by the TelemetryPublisher, so a short
+    // cadence costs airtime only when something moved (or on heartbeat).
     void begin(uint32_t intervalMs = 7000);
 
     // Call from loop()
@@ -27,6 +32,16 @@ public:
     // Optional: push immediately (e.g., on state change or MQTT reconnect)
     void publishNow();
 
+    // Optional: reconnect counters on TOPIC_ESP_LINK
+    void setLinkSource(const MqttManager *mqtt, const WiFiManager *wifi)
+    {
+        link_ = mqtt;
+        wifi_ = wifi;
+    }
+
+    // Optional: acquisition task health on TOPIC_ESP_SAMPLING
+    void setSamplingSource(const SamplingTask *sampler) { sampler_ = sampler; }
+
     // Change interval at runtime
     void setInterval(uint32_t ms) { intervalMs_ = ms; }
 
@@ -35,18 +50,25 @@ private:
 
     // Retained flags
     static constexpr bool R_LIGHTS = true;
-    static constexpr bool R_FEEDER = false;
+    static constexpr bool R_FEEDER = true; // FeederManager publishes it retained too
     static constexpr bool R_AUTO = true;
     static constexpr bool R_FEED_COUNT = true;
     static constexpr bool R_IP = true;
     static constexpr bool R_MQTT = true;
-    static constexpr bool R_HEAP = true;
-    static constexpr bool R_UPTIME = true;
+
+    // Deadbands for values that move every tick
+    static constexpr float HEAP_DEADBAND_KB = 4.0f;
+    static constexpr float UPTIME_STEP_MS = 300000.0f;
+    static constexpr float TELEMETRY_STEP = 100.0f; // sends
+    static constexpr float OVERRUN_STEP = 1.0f;     // any new overrun goes out
 
     LightManager &lights_;
     FeederManager &feeder_;
     AutoModeManager &autoMode_;
-    MqttManager &mqtt_;
+    TelemetryPublisher &mqtt_;
+    const MqttManager *link_ = nullptr;
+    const WiFiManager *wifi_ = nullptr;
+    const SamplingTask *sampler_ = nullptr;
 
     uint32_t intervalMs_ = 7000;
     uint32_t lastTick_ = 0;
@@ -0,0 +1,331 @@
+#include "storage/telemetry_log.h"
+#include <LittleFS.h>
+#include "mqtt/telemetry_publisher.h"
+#include "Temp_sensor/temp_sensor_manager.h"
+#include "current_sensor/current_sensor_manager.h"
+#include "topics.h"
+
+static const char *const TLOG_DIR = "/tlog";
+static constexpr uint8_t RECORD_MAGIC = 0xA5;
+
+bool TelemetryLog::begin(TelemetryPublisher &telemetry,
+                         TempSensorManager &tempsRef,
+                         CurrentSensorManager &currentsRef)
+{
+    client = &telemetry;
+    temps = &tempsRef;
+    currents = &currentsRef;
+
+    // formatOnFail: a blank or corrupt partition becomes an empty log
+    mounted = LittleFS.begin(true);
+    if (!mounted)
+    {
+        Serial.println(F("[TLOG] LittleFS mount failed; store-and-forward off"));
+        return false;
+    }
+    if (!LittleFS.exists(TLOG_DIR))
+        LittleFS.mkdir(TLOG_DIR);
+
+    // Never plan for more than 3/4 of the partition
+    const uint32_t fsCap = uint32_t(LittleFS.totalBytes() / 4 * 3);
+    if (cfg.maxBytes > fsCap)
+        cfg.maxBytes = fsCap;
+    if (cfg.maxBytes < 2 * SEGMENT_BYTES)
+        cfg.maxBytes = 2 * SEGMENT_BYTES;
+
+    scan_();
+    Serial.printf("[TLOG] %lu records pending in segments %lu..%lu\n",
+                  (unsigned long)depth(), (unsigned long)tailSeg, (unsigned long)headSeg);
+    return true;
+}
+
+// Rebuild the ring from the directory (boot)
+void TelemetryLog::scan_()
+{
+    bool any = false;
+    uint32_t lo = 0, hi = 0;
+    storedBytes = 0;
+
+    File dir = LittleFS.open(TLOG_DIR);
+    for (File f = dir.openNextFile(); f; f = dir.openNextFile())
+    {
+        const char *name = strrchr(f.name(), '/');
+        name = name ? name + 1 : f.name();
+        char *end = nullptr;
+        const uint32_t seg = strtoul(name, &end, 10);
+        if (end == name || strcmp(end, ".bin") != 0)
+            continue;
+        storedBytes += uint32_t(f.size() / RECORD_BYTES * RECORD_BYTES);
+        if (!any || seg < lo)
+            lo = seg;
+        if (!any || seg > hi)
+        {
+            hi = seg;
+            headBytes = uint32_t(f.size());
+        }
+        any = true;
+    }
+
+    tailSeg = any ? lo : 0;
+    headSeg = any ? hi : 0;
+    if (!any)
+        headBytes = 0;
+    readOff = 0;
+}
+
+void TelemetryLog::segPath_(uint32_t seg, char *out, size_t len)
+{
+    snprintf(out, len, "%s/%08lu.bin", TLOG_DIR, (unsigned long)seg);
+}
+
+void TelemetryLog::encode_(const Record &r, uint8_t *out)
+{
+    uint32_t v;
+    memcpy(&v, &r.value, sizeof(v));
+    for (int i = 0; i < 4; ++i)
+    {
+        out[i] = uint8_t(r.ts >> (8 * i));
+        out[4 + i] = uint8_t(v >> (8 * i));
+    }
+    out[8] = r.channel;
+    out[9] = 0;
+    out[10] = RECORD_MAGIC;
+    uint8_t x = 0;
+    for (int i = 0; i < 11; ++i)
+        x ^= out[i];
+    out[11] = x;
+}
+
+bool TelemetryLog::decode_(const uint8_t *in, Record &r)
+{
+    uint8_t x = 0;
+    for (int i = 0; i < 11; ++i)
+        x ^= in[i];
+    if (in[10] != RECORD_MAGIC || x != in[11])
+        return false;
+    uint32_t ts = 0, v = 0;
+    for (int i = 0; i < 4; ++i)
+    {
+        ts |= uint32_t(in[i]) << (8 * i);
+        v |= uint32_t(in[4 + i]) << (8 * i);
+    }
+    r.ts = ts;
+    memcpy(&r.value, &v, sizeof(v));
+    r.channel = in[8];
+    return true;
+}
+
+const char *TelemetryLog::channelName_(uint8_t channel)
+{
+    if (channel >= CH_CURRENT_BASE && size_t(channel - CH_CURRENT_BASE) < CURRENT_CHANNEL_COUNT)
+        return CURRENT_CHANNELS[channel - CH_CURRENT_BASE].name;
+    if (size_t(channel - CH_TEMP_BASE) < TEMP_PROBE_COUNT)
+        return TEMP_PROBES[channel - CH_TEMP_BASE].name;
+    return "?";
+}
+
+void TelemetryLog::update(uint32_t rtcSeconds)
+{
+    if (!mounted)
+        return;
+    const uint32_t now = millis();
+    const bool online = client->connected();
+
+    if (!online)
+    {
+        if (now - lastSampleMs >= cfg.sampleIntervalMs)
+        {
+            lastSampleMs = now;
+            sample_(rtcSeconds);
+        }
+        if (staged && now - stagedSinceMs >= cfg.flushMaxMs)
+            flush_();
+    }
+    else
+    {
+        // Back online: the outage tail goes to flash first so replay stays in order
+        if (!wasOnline && staged)
+            flush_();
+        if (storedBytes && now - lastReplayMs >= cfg.replayIntervalMs)
+        {
+            lastReplayMs = now;
+            replayOnce_();
+        }
+    }
+    wasOnline = online;
+
+    if (now - lastStatusMs >= cfg.statusIntervalMs)
+    {
+        lastStatusMs = now;
+        publishStatus_();
+    }
+}
+
+void TelemetryLog::sample_(uint32_t rtcSeconds)
+{
+    for (size_t i = 0; i < TEMP_PROBE_COUNT; ++i)
+    {
+        if (temps->isPresent(i))
+            append_({rtcSeconds, temps->getTempFf(i), uint8_t(CH_TEMP_BASE + i)});
+    }
+    for (size_t ch = 0; ch < currents->channelCount(); ++ch)
+        append_({rtcSeconds, currents->lastA(ch), uint8_t(CH_CURRENT_BASE + ch)});
+}
+
+void TelemetryLog::append_(const Record &r)
+{
+    if (staged == 0)
+        stagedSinceMs = millis();
+    encode_(r, stage + staged * RECORD_BYTES);
+    if (++staged == STAGE_RECORDS)
+        flush_();
+}
+
+// One write of everything staged; a full stage is one flash block
+bool TelemetryLog::flush_()
+{
+    if (!staged)
+        return true;
+    if (headBytes >= SEGMENT_BYTES)
+    {
+        ++headSeg;
+        headBytes = 0;
+    }
+
+    char path[32];
+    segPath_(headSeg, path, sizeof(path));
+    File f = LittleFS.open(path, FILE_APPEND);
+    const size_t bytes = staged * RECORD_BYTES;
+    const size_t wrote = f ? f.write(stage, bytes) : 0;
+    if (f)
+        f.close();
+    if (wrote != bytes)
+    {
+        // Filesystem full or failing: lose this batch rather than stall loop()
+        dropped += staged;
+        staged = 0;
+        Serial.println(F("[TLOG] flush failed; batch dropped"));
+        return false;
+    }
+
+    headBytes += bytes;
+    storedBytes += bytes;
+    staged = 0;
+    trim_();
+    return true;
+}
+
+// Keep the ring inside maxBytes: oldest segment goes first
+void TelemetryLog::trim_()
+{
+    while (tailSeg < headSeg && (headSeg - tailSeg + 1) * SEGMENT_BYTES > cfg.maxBytes)
+    {
+        char path[32];
+        segPath_(tailSeg, path, sizeof(path));
+        File f = LittleFS.open(path, FILE_READ);
+        const uint32_t size = f ? uint32_t(f.size() / RECORD_BYTES * RECORD_BYTES) : 0;
+        if (f)
+            f.close();
+        const uint32_t unread = size > readOff ? size - readOff : 0;
+        dropped += unread / RECORD_BYTES;
+        storedBytes -= unread;
+        LittleFS.remove(path);
+        ++tailSeg;
+        readOff = 0;
+    }
+}
+
+bool TelemetryLog::replayOnce_()
+{
+    char path[32];
+    segPath_(tailSeg, path, sizeof(path));
+    File f = LittleFS.open(path, FILE_READ);
+    const uint32_t size = f ? uint32_t(f.size() / RECORD_BYTES * RECORD_BYTES) : 0;
+
+    if (readOff >= size)
+    {
+        // Missing or already drained (tail advanced past a partial trim)
+        if (f)
+            f.close();
+        retireTail_();
+        return false;
+    }
+
+    uint8_t raw[REPLAY_BATCH * RECORD_BYTES];
+    f.seek(readOff);
+    uint32_t n = uint32_t(f.read(raw, sizeof(raw)));
+    f.close();
+    n = n / RECORD_BYTES;
+    if (n > (size - readOff) / RECORD_BYTES)
+        n = (size - readOff) / RECORD_BYTES;
+    if (n == 0)
+        return false;
+
+    // {"r":[[ts,"name",value],...],"left":N}
+    char buf[256];
+    size_t len = snprintf(buf, sizeof(buf), "{\"r\":[");
+    uint32_t good = 0, bad = 0;
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        Record r;
+        if (!decode_(raw + i * RECORD_BYTES, r))
+        {
+            ++bad;
+            continue;
+        }
+        len += snprintf(buf + len, sizeof(buf) - len, "%s[%lu,\"%s\",%.2f]",
+                        good ? "," : "", (unsigned long)r.ts, channelName_(r.channel), r.value);
+        ++good;
+    }
+    const uint32_t left = (storedBytes - n * RECORD_BYTES) / RECORD_BYTES;
+    len += snprintf(buf + len, sizeof(buf) - len, "],\"left\":%lu}", (unsigned long)left);
+    if (len >= sizeof(buf))
+        return false; // cannot happen with REPLAY_BATCH sized for PAYLOAD_MAX
+
+    if (good && !client->publish(TOPIC_TELEMETRY_REPLAY, buf, false))
+        return false; // outbox full / link dropped: same records next interval
+
+    readOff += n * RECORD_BYTES;
+    storedBytes -= n * RECORD_BYTES;
+    replayed += good;
+    dropped += bad;
+    replayWindowCount += good;
+    if (readOff >= size)
+        retireTail_(); // delete now, so a reboot can't replay it again
+    return true;
+}
+
+// Tail segment fully replayed: delete it and move to the next one
+void TelemetryLog::retireTail_()
+{
+    char path[32];
+    segPath_(tailSeg, path, sizeof(path));
+    LittleFS.remove(path);
+    if (tailSeg == headSeg)
+    {
+        // Ring drained: the next outage starts a fresh segment
+        ++headSeg;
+        headBytes = 0;
+        storedBytes = 0;
+    }
+    ++tailSeg;
+    readOff = 0;
+}
+
+void TelemetryLog::publishStatus_()
+{
+    const uint32_t now = millis();
+    const uint32_t windowMs = now - replayWindowStartMs;
+    if (windowMs > 0)
+        replayRatePerS = replayWindowCount * 1000.0f / windowMs;
+    replayWindowStartMs = now;
+    replayWindowCount = 0;
+
+    const char *state = !client->connected() ? "logging" : (storedBytes ? "replaying" : "idle");
+    char buf[160];
+    snprintf(buf, sizeof(buf),
+             "{\"state\":\"%s\",\"depth\":%lu,\"bytes\":%lu,\"replayed\":%lu,\"dropped\":%lu,\"rate\":%.1f}",
+             state, (unsigned long)depth(), (unsigned long)storedBytes,
+             (unsigned long)replayed, (unsigned long)dropped, replayRatePerS);
+    client->publish(TOPIC_ESP_REPLAY, buf, true); // unchanged while idle → suppressed
+}
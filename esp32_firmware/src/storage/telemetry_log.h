@@ -0,0 +1,117 @@
+#ifndef TELEMETRY_LOG_H
+#define TELEMETRY_LOG_H
+
+#include <Arduino.h>
+
+class TelemetryPublisher;
+class TempSensorManager;
+class CurrentSensorManager;
+
+// Store-and-forward for broker outages. While MQTT is down, every
+// sampleIntervalMs one record per present temperature probe and per CT
+// channel goes into an append-only ring log on LittleFS; after reconnect the
+// log is replayed oldest-first on TOPIC_TELEMETRY_REPLAY with the original
+// timestamps, one message per replayIntervalMs.
+//
+//  - Records are staged in RAM and written a whole flash block (4 KB) at a
+//    time, so littlefs never rewrites a partial tail block. A staged batch is
+//    also flushed after flushMaxMs (caps what a power cut loses) and when the
+//    link comes back (replay order).
+//  - The ring is a run of numbered segment files (/tlog/<n>.bin). Past
+//    maxBytes the oldest segment is deleted and its records counted as dropped.
+//  - A segment is deleted once fully replayed; the offset inside the current
+//    one lives in RAM only, so a reboot mid-replay re-sends that segment's
+//    head (at-least-once: consumers dedupe on timestamp + channel).
+//  - Depth and replay throughput go to TOPIC_ESP_REPLAY.
+class TelemetryLog
+{
+public:
+    struct Config
+    {
+        uint32_t sampleIntervalMs = 10000; // per channel, while offline
+        uint32_t replayIntervalMs = 250;   // one replay message per interval
+        uint32_t flushMaxMs = 600000;      // staged records older than this get written
+        uint32_t maxBytes = 1024UL * 1024; // ring budget on the filesystem
+        uint32_t statusIntervalMs = 5000;
+    };
+
+    // One logged sample. 12 bytes on flash, little-endian, packed by hand.
+    struct Record
+    {
+        uint32_t ts;     // RTC seconds since 1970 (local time, as the RTC keeps it)
+        float value;     // °F or A
+        uint8_t channel; // CH_TEMP_BASE + probe, CH_CURRENT_BASE + CT channel
+    };
+    static constexpr uint8_t CH_TEMP_BASE = 0;
+    static constexpr uint8_t CH_CURRENT_BASE = 16;
+    static constexpr size_t RECORD_BYTES = 12;
+
+    // Set before begin(): maxBytes is clamped to the partition there
+    void setConfig(const Config &c) { cfg = c; }
+
+    // Mounts LittleFS (formats a blank partition) and picks up any backlog
+    bool begin(TelemetryPublisher &telemetry,
+               TempSensorManager &temps,
+               CurrentSensorManager &currents);
+
+    // Call from loop() with the RTC time (DateTime::unixtime())
+    void update(uint32_t rtcSeconds);
+
+    // Counters / state
+    uint32_t depth() const { return uint32_t(storedBytes / RECORD_BYTES) + staged; }
+    uint32_t replayedCount() const { return replayed; }
+    uint32_t droppedCount() const { return dropped; }
+    float replayRate() const { return replayRatePerS; } // records/s, last replay window
+
+private:
+    static constexpr size_t BLOCK_BYTES = 4096;
+    static constexpr size_t STAGE_RECORDS = BLOCK_BYTES / RECORD_BYTES;
+    static constexpr uint32_t SEGMENT_BYTES = STAGE_RECORDS * RECORD_BYTES * 16; // 16 blocks
+    static constexpr size_t REPLAY_BATCH = 6; // records per message: ≤ 32 chars each, fits PAYLOAD_MAX
+
+    TelemetryPublisher *client = nullptr;
+    TempSensorManager *temps = nullptr;
+    CurrentSensorManager *currents = nullptr;
+    Config cfg;
+    bool mounted = false;
+
+    // Ring: segments [tailSeg, headSeg]; read cursor inside tailSeg
+    uint32_t tailSeg = 0;
+    uint32_t headSeg = 0;
+    uint32_t headBytes = 0;
+    uint32_t readOff = 0;
+    uint32_t storedBytes = 0; // on flash, not yet replayed
+
+    uint8_t stage[STAGE_RECORDS * RECORD_BYTES];
+    uint32_t staged = 0;
+    uint32_t stagedSinceMs = 0;
+
+    uint32_t lastSampleMs = 0;
+    uint32_t lastReplayMs = 0;
+    uint32_t lastStatusMs = 0;
+    bool wasOnline = false;
+
+    // Throughput: records replayed since the window started
+    uint32_t replayWindowStartMs = 0;
+    uint32_t replayWindowCount = 0;
+    float replayRatePerS = 0.0f;
+
+    uint32_t replayed = 0;
+    uint32_t dropped = 0;
+
+    void scan_();
+    void sample_(uint32_t rtcSeconds);
+    void append_(const Record &r);
+    bool flush_();
+    void trim_();
+    bool replayOnce_();
+    void retireTail_();
+    void publishStatus_();
+
+    static void segPath_(uint32_t seg, char *out, size_t len);
+    static void encode_(const Record &r, uint8_t *out);
+    static bool decode_(const uint8_t *in, Record &r);
+    static const char *channelName_(uint8_t channel);
+};
+
+#endif // TELEMETRY_LOG_H
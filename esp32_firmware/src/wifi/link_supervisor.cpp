@@ -0,0 +1,130 @@
+#include "wifi/link_supervisor.h"
+
+void ReconnectBackoff::configure(uint32_t base, uint32_t cap)
+{
+    baseMs = base ? base : 1;
+    capMs = cap < baseMs ? baseMs : cap;
+}
+
+uint32_t ReconnectBackoff::rand_()
+{
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+void ReconnectBackoff::fail(uint32_t now)
+{
+    ++failures;
+    uint32_t d = baseMs;
+    for (uint32_t i = 1; i < failures && d < capMs; ++i)
+        d = d > capMs / 2 ? capMs : d * 2;
+    if (d > capMs)
+        d = capMs;
+    delayMs = d / 2 + rand_() % (d / 2 + 1);
+    nextAt = now + delayMs;
+    waiting = true;
+}
+
+void LinkSupervisor::setConfig(const Config &c)
+{
+    cfg = c;
+    wifiBackoff.configure(cfg.wifiBaseMs, cfg.wifiCapMs);
+    mqttBackoff.configure(cfg.mqttBaseMs, cfg.mqttCapMs);
+}
+
+void LinkSupervisor::seed(uint32_t s)
+{
+    wifiBackoff.seed(s);
+    mqttBackoff.seed(s * 2654435761u + 1);
+}
+
+LinkSupervisor::Action LinkSupervisor::poll(uint32_t now, Wifi wifi, int mqttState)
+{
+    if (!started)
+    {
+        // WiFiManager::begin() already started the first association
+        started = true;
+        associating = true;
+        attemptStart = now;
+        downSince = now;
+    }
+
+    const bool wifiUp = wifi == Wifi::Up;
+    const bool mqttUp = wifiUp && mqttState == MQTT_STATE_CONNECTED;
+
+    // ---- edges ----
+    if (mqttWasUp && !mqttUp)
+    {
+        downSince = now;
+        if (wifiUp)
+        {
+            ++st.mqttDrops;
+            if (mqttState == MQTT_STATE_KEEPALIVE)
+                ++st.mqttKeepalive;
+            else if (mqttState == MQTT_STATE_LOST)
+                ++st.mqttLost;
+        }
+        mqttBackoff.reset();
+        mqttBackoff.fail(now); // broker just went away: short jittered pause first
+    }
+    if (wifiWasUp && !wifiUp)
+    {
+        ++st.wifiDrops;
+        wifiBackoff.reset();
+        wifiBackoff.fail(now); // an AP reboot takes seconds; don't retry on the spot
+    }
+    if (!wifiWasUp && wifiUp)
+    {
+        associating = false;
+        wifiBackoff.reset();
+        mqttBackoff.reset(); // fast path: new IP, try the broker right away
+    }
+    wifiWasUp = wifiUp;
+    mqttWasUp = mqttUp;
+
+    // ---- Wi-Fi ----
+    if (!wifiUp)
+    {
+        if (associating)
+        {
+            const uint32_t elapsed = now - attemptStart;
+            const bool failed = wifi == Wifi::Failed && elapsed >= FAIL_SETTLE_MS;
+            if (!failed && elapsed < cfg.wifiBudgetMs)
+                return Action::None;
+            associating = false;
+            ++st.wifiFailures;
+            wifiBackoff.fail(now);
+            return Action::WifiAbort;
+        }
+        if (!wifiBackoff.ready(now))
+            return Action::None;
+        associating = true;
+        attemptStart = now;
+        ++st.wifiAttempts;
+        return Action::WifiConnect;
+    }
+
+    // ---- MQTT ----
+    if (mqttUp || !mqttBackoff.ready(now))
+        return Action::None;
+    ++st.mqttAttempts;
+    return Action::MqttConnect;
+}
+
+void LinkSupervisor::mqttResult(bool ok, uint32_t now)
+{
+    if (!ok)
+    {
+        ++st.mqttFailures;
+        mqttBackoff.fail(now);
+        return;
+    }
+    mqttBackoff.reset();
+    mqttWasUp = true;
+    ++st.reconnects;
+    st.lastReconnectMs = now - downSince;
+    if (st.lastReconnectMs > st.maxReconnectMs)
+        st.maxReconnectMs = st.lastReconnectMs;
+}
@@ -0,0 +1,127 @@
+#ifndef LINK_SUPERVISOR_H
+#define LINK_SUPERVISOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Exponential backoff with "equal jitter": the n-th wait is d/2 + rand(d/2),
+// d = min(cap, base * 2^(n-1)). Devices that lost the same AP/broker spread
+// their retries out instead of arriving together.
+class ReconnectBackoff
+{
+public:
+    void configure(uint32_t baseMs, uint32_t capMs);
+    void seed(uint32_t s) { rng = s ? s : 0x9E3779B9u; }
+
+    // Next attempt may go now
+    void reset()
+    {
+        failures = 0;
+        waiting = false;
+    }
+    void fail(uint32_t now); // count a failure, schedule the next attempt
+    bool ready(uint32_t now) const { return !waiting || int32_t(now - nextAt) >= 0; }
+
+    uint32_t failureCount() const { return failures; }
+    uint32_t lastDelayMs() const { return delayMs; }
+
+private:
+    uint32_t baseMs = 1000;
+    uint32_t capMs = 60000;
+    uint32_t failures = 0;
+    uint32_t delayMs = 0;
+    uint32_t nextAt = 0;
+    bool waiting = false;
+    uint32_t rng = 0x9E3779B9u; // xorshift32
+
+    uint32_t rand_();
+};
+
+// Reconnect policy for Wi-Fi and MQTT, one place for both. Host-buildable:
+// it only decides, the caller (MqttManager's network task) does the I/O and
+// reports the link state on every poll.
+//
+//  - Wi-Fi first. One association attempt at a time with a hard budget;
+//    past it (or on an early failure) the attempt is aborted and backed off.
+//  - MQTT only while Wi-Fi is up. Each failed connect backs off; the
+//    per-attempt time bound is the transport's (TCP + CONNACK timeouts).
+//  - Fast path: when Wi-Fi comes up (new IP), the MQTT backoff is reset and
+//    the broker is tried on the next poll.
+//  - Counters: drops and their cause, attempts, failures, time to reconnect
+//    (link lost → MQTT session up again).
+class LinkSupervisor
+{
+public:
+    struct Config
+    {
+        uint32_t wifiBudgetMs = 10000; // association + DHCP, per attempt
+        uint32_t wifiBaseMs = 1000;
+        uint32_t wifiCapMs = 60000;
+        uint32_t mqttBaseMs = 1000;
+        uint32_t mqttCapMs = 60000;
+    };
+
+    enum class Wifi : uint8_t
+    {
+        Down,   // disconnected / associating
+        Up,     // associated, has an IP
+        Failed  // attempt ended early (no SSID, auth)
+    };
+
+    enum class Action : uint8_t
+    {
+        None,
+        WifiConnect, // start an association (non-blocking)
+        WifiAbort,   // budget spent: drop the attempt
+        MqttConnect  // try the broker now, then report mqttResult()
+    };
+
+    // PubSubClient::state() values the counters tell apart
+    static constexpr int MQTT_STATE_CONNECTED = 0;
+    static constexpr int MQTT_STATE_KEEPALIVE = -4; // MQTT_CONNECTION_TIMEOUT
+    static constexpr int MQTT_STATE_LOST = -3;      // MQTT_CONNECTION_LOST
+
+    struct Stats
+    {
+        uint32_t wifiDrops = 0;
+        uint32_t wifiAttempts = 0;
+        uint32_t wifiFailures = 0; // budget spent or early failure
+        uint32_t mqttDrops = 0;    // while Wi-Fi stayed up
+        uint32_t mqttKeepalive = 0; //  ... of those: broker stopped answering
+        uint32_t mqttLost = 0;      //  ... socket closed
+        uint32_t mqttAttempts = 0;
+        uint32_t mqttFailures = 0;
+        uint32_t reconnects = 0;
+        uint32_t lastReconnectMs = 0; // link lost → MQTT up
+        uint32_t maxReconnectMs = 0;
+    };
+
+    void setConfig(const Config &c);
+    void seed(uint32_t s);
+
+    // Call every pass of the network task. mqttState: PubSubClient::state(),
+    // 0 = connected (only meaningful while Wi-Fi is up).
+    Action poll(uint32_t now, Wifi wifi, int mqttState);
+    // Outcome of the MqttConnect just performed
+    void mqttResult(bool ok, uint32_t now);
+
+    const Stats &stats() const { return st; }
+
+private:
+    // A fresh attempt can still read the previous one's failure status
+    static constexpr uint32_t FAIL_SETTLE_MS = 1000;
+
+    Config cfg;
+    ReconnectBackoff wifiBackoff;
+    ReconnectBackoff mqttBackoff;
+    Stats st;
+
+    bool started = false;
+    bool wifiWasUp = false;
+    bool mqttWasUp = false;
+    bool associating = false;
+    uint32_t attemptStart = 0;
+    uint32_t downSince = 0; // link (Wi-Fi or MQTT) lost at
+};
+
+#endif // LINK_SUPERVISOR_H
@@ -15,7 +15,7 @@ void WiFiManager::begin()
         return;
     }
 
-    WiFi.onEvent([](arduino_event_id_t event, arduino_event_info_t info)
+    WiFi.onEvent([this](arduino_event_id_t event, arduino_event_info_t info)
                  {
         if (event == ARDUINO_EVENT_WIFI_STA_CONNECTED) {
             Serial.println("[WiFi] Connected to AP");
@@ -23,11 +23,21 @@ void WiFiManager::begin()
             Serial.print("[WiFi] Got IP: ");
             Serial.println(WiFi.localIP());
         } else if (event == ARDUINO_EVENT_WIFI_STA_DISCONNECTED) {
-            Serial.println("[WiFi] Disconnected, retrying...");
-            WiFi.reconnect();
+            const uint8_t reason = info.wifi_sta_disconnected.reason;
+            Serial.printf("[WiFi] Disconnected, reason %u\n", reason);
+            switch (reason) {
+            case WIFI_REASON_BEACON_TIMEOUT: ++drops.beaconTimeout; break;
+            case WIFI_REASON_NO_AP_FOUND: ++drops.noApFound; break;
+            case WIFI_REASON_AUTH_EXPIRE:
+            case WIFI_REASON_AUTH_FAIL:
+            case WIFI_REASON_4WAY_HANDSHAKE_TIMEOUT:
+            case WIFI_REASON_HANDSHAKE_TIMEOUT: ++drops.authFail; break;
+            default: ++drops.other; break;
+            }
         } });
 
     WiFi.mode(WIFI_STA);
+    WiFi.setAutoReconnect(false); // retries are paced by the MQTT task's LinkSupervisor
     WiFi.begin(ssid.c_str(), password.c_str());
 
     Serial.print("[WiFi] Connecting to ");
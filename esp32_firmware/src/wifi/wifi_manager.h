@@ -4,16 +4,30 @@
 #include <Arduino.h>
 #include <WiFi.h>
 
+// Credentials from NVS and the first association. Reconnecting is not done
+// here: MqttManager's network task owns it (LinkSupervisor), so the event
+// handler only logs and counts disconnect reasons.
 class WiFiManager
 {
 public:
+    // STA_DISCONNECTED events by reason (failed attempts included)
+    struct DisconnectCounts
+    {
+        uint32_t beaconTimeout = 0; // AP went silent (reboot, range)
+        uint32_t noApFound = 0;
+        uint32_t authFail = 0; // auth/handshake failures and timeouts
+        uint32_t other = 0;
+    };
+
     void begin();
     String getSSID() const;
     String getPassword() const;
     String getIP() const;
     bool isConnected() const;
+    const DisconnectCounts &disconnects() const { return drops; }
 
 private:
+    DisconnectCounts drops; // written from the Wi-Fi event task
     String ssid;
     String password;
 };
@@ -0,0 +1,125 @@
+// Host-side decoder for waveform capture chunks (include/capture_frame.h) → CSV.
+//
+// Build:   g++ -std=c++17 -O2 -I../include capture_to_csv.cpp -o capture_to_csv
+// Record:  mosquitto_sub -h <broker> -t 'turtle/sensors/current/+/capture' -N > cap.bin
+//          (-N: no delimiter, chunks are self-delimiting)
+// Decode:  ./capture_to_csv cap.bin > cap.csv      (or pipe into stdin)
+//
+// Output columns: channel,capture_id,index,t_us,raw,amps
+// t_us is reconstructed from t0Us + index * spanUs / (totalSamples - 1).
+// Missing chunks are reported on stderr and their samples are left out.
+
+#include <cstdio>
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
+#include "capture_frame.h"
+
+namespace
+{
+    struct Capture
+    {
+        CaptureChunkHeader h;
+        std::vector<int16_t> samples;
+        std::vector<bool> have;
+        std::vector<bool> chunkSeen;
+    };
+
+    bool readAll(FILE *f, std::vector<uint8_t> &out)
+    {
+        uint8_t buf[4096];
+        size_t n;
+        while ((n = fread(buf, 1, sizeof(buf), f)) > 0)
+            out.insert(out.end(), buf, buf + n);
+        return !ferror(f);
+    }
+
+    void addChunks(const std::vector<uint8_t> &data, std::map<std::pair<int, int>, Capture> &caps)
+    {
+        size_t pos = 0;
+        while (pos < data.size())
+        {
+            CaptureChunkHeader h;
+            const uint8_t *samples = nullptr;
+            const size_t len = captureDecodeChunk(data.data() + pos, data.size() - pos, h, samples);
+            if (!len)
+            {
+                ++pos; // resync on the next magic
+                continue;
+            }
+            pos += len;
+
+            Capture &c = caps[{h.channel, h.captureId}];
+            if (c.samples.empty())
+            {
+                c.h = h;
+                c.samples.assign(h.totalSamples, 0);
+                c.have.assign(h.totalSamples, false);
+                c.chunkSeen.assign(h.chunkCount, false);
+            }
+            if (h.seq < c.chunkSeen.size())
+                c.chunkSeen[h.seq] = true;
+            for (uint16_t i = 0; i < h.sampleCount; ++i)
+            {
+                const size_t idx = size_t(h.firstIndex) + i;
+                if (idx >= c.samples.size())
+                    break;
+                c.samples[idx] = captureSampleAt(samples, i);
+                c.have[idx] = true;
+            }
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    std::vector<uint8_t> data;
+    if (argc < 2)
+    {
+        if (!readAll(stdin, data))
+            return 1;
+    }
+    for (int a = 1; a < argc; ++a)
+    {
+        FILE *f = fopen(argv[a], "rb");
+        if (!f || !readAll(f, data))
+        {
+            fprintf(stderr, "cannot read %s\n", argv[a]);
+            return 1;
+        }
+        fclose(f);
+    }
+
+    std::map<std::pair<int, int>, Capture> caps;
+    addChunks(data, caps);
+    if (caps.empty())
+    {
+        fprintf(stderr, "no capture chunks found\n");
+        return 1;
+    }
+
+    printf("channel,capture_id,index,t_us,raw,amps\n");
+    for (const auto &kv : caps)
+    {
+        const Capture &c = kv.second;
+        size_t missing = 0;
+        for (bool seen : c.chunkSeen)
+            missing += seen ? 0 : 1;
+        if (missing)
+            fprintf(stderr, "channel %u capture %u: %zu of %u chunks missing\n",
+                    c.h.channel, c.h.captureId, missing, c.h.chunkCount);
+
+        const double dtUs = c.h.totalSamples > 1 ? double(c.h.spanUs) / (c.h.totalSamples - 1)
+                                                 : (c.h.sps ? 1e6 / c.h.sps : 0.0);
+        for (size_t i = 0; i < c.samples.size(); ++i)
+        {
+            if (!c.have[i])
+                continue;
+            const double amps = (c.samples[i] - c.h.offsetCounts) * c.h.ampsPerCount;
+            printf("%u,%u,%zu,%.1f,%d,%.5f\n", c.h.channel, c.h.captureId, i,
+                   c.h.t0Us + i * dtUs, c.samples[i], amps);
+        }
+    }
+    return 0;
+}
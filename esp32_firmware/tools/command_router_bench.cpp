@@ -0,0 +1,364 @@
+// Host-side allocation / latency bench for the command dispatch path
+// (src/mqtt/command_parse.h, as used by MqttCommandRouter::handle).
+//
+// Build:   g++ -std=c++17 -O2 -I../src -I../include command_router_bench.cpp ../src/mqtt/command_parse.cpp -o command_router_bench
+// Run:     ./command_router_bench          (exit status 0 = decode checks passed, no allocations)
+//
+// The router itself needs Arduino and the managers, so this reproduces its
+// parse side with the same pieces: the ROUTES table over topics.h, the
+// envelope (trim, '{' sniff, FlatJson, "id"/"cmd") and the per-command payload
+// decode, with the actuator calls replaced by writes into a Decoded record.
+// Global operator new/delete are replaced to count heap allocations.
+//
+// For comparison, the pre-cmdparse shape: payload copied into a string, a
+// lower-cased second copy, a strcmp chain over the topics. std::string keeps
+// up to 15 chars inline, so short tokens that cost Arduino String a heap copy
+// on the target are free here; the legacy allocation count is a lower bound
+// (and the ArduinoJson documents it also built are not modelled).
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include "mqtt/command_parse.h"
+#include "topics.h"
+
+namespace
+{
+    size_t allocations = 0;
+}
+
+void *operator new(size_t n)
+{
+    ++allocations;
+    if (void *p = std::malloc(n ? n : 1))
+        return p;
+    throw std::bad_alloc();
+}
+void *operator new[](size_t n) { return operator new(n); }
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+void operator delete[](void *p, size_t) noexcept { std::free(p); }
+
+namespace
+{
+    using cmdparse::FlatJson;
+    using cmdparse::Span;
+    using cmdparse::tokenIs;
+
+    // Same order and ids as mqtt_command_router.cpp
+    enum Command : uint8_t
+    {
+        CMD_FEEDER,
+        CMD_AUTO_MODE,
+        CMD_LIGHTS,
+        CMD_HEAT,
+        CMD_UV,
+        CMD_REBOOT,
+        CMD_SCHEDULE,
+        CMD_THERMOSTAT,
+        CMD_CAPTURE,
+        CMD_PROBES,
+        CMD_UNKNOWN
+    };
+
+    constexpr cmdparse::Route ROUTES[] = {
+        {TOPIC_FEEDER_CMD, CMD_FEEDER},
+        {TOPIC_AUTO_MODE_CMD, CMD_AUTO_MODE},
+        {TOPIC_LIGHTS_CMD, CMD_LIGHTS},
+        {TOPIC_HEAT_CMD, CMD_HEAT},
+        {TOPIC_UV_CMD, CMD_UV},
+        {TOPIC_REBOOT_CMD, CMD_REBOOT},
+        {TOPIC_LIGHTS_SCHEDULE_CMD, CMD_SCHEDULE},
+        {TOPIC_HEAT_THERMOSTAT_CMD, CMD_THERMOSTAT},
+        {TOPIC_CURRENT_CAPTURE_CMD, CMD_CAPTURE},
+        {TOPIC_TEMP_PROBES_CMD, CMD_PROBES},
+    };
+    constexpr size_t ROUTE_COUNT = sizeof(ROUTES) / sizeof(ROUTES[0]);
+
+    constexpr cmdparse::TopicTable<ROUTE_COUNT, 16> TOPIC_TABLE(ROUTES);
+    static_assert(TOPIC_TABLE.valid(), "command topics: no collision-free hash seed (raise SLOTS)");
+
+    // What the router would have done, minus the side effects
+    struct Decoded
+    {
+        uint8_t cmd = CMD_UNKNOWN;
+        bool ok = false;  // R_APPLIED
+        int value = 0;    // on=1/off=0, HHMM sum, channel initial + cycles, ...
+        size_t idLen = 0; // correlation ID echoed in the ack
+    };
+
+    struct Envelope
+    {
+        Span token;
+        Span id;
+        FlatJson doc;
+        bool json = false;
+        bool jsonOk = false;
+    };
+
+    int onOff(Span tok)
+    {
+        return tokenIs(tok, "on") ? 1 : tokenIs(tok, "off") ? 0 : -1;
+    }
+
+    bool dispatch(uint8_t cmd, const Envelope &env, Decoded &d)
+    {
+        const Span &tok = env.token;
+        switch (cmd)
+        {
+        case CMD_FEEDER:
+            return tokenIs(tok, "1") || tokenIs(tok, "feed");
+        case CMD_AUTO_MODE:
+        case CMD_LIGHTS:
+        case CMD_HEAT:
+        case CMD_UV:
+            d.value = onOff(tok);
+            return d.value >= 0;
+        case CMD_REBOOT:
+            return tokenIs(tok, "1") || tokenIs(tok, "now");
+        case CMD_SCHEDULE:
+        {
+            if (!env.jsonOk)
+                return false;
+            int on = 800, off = 1800;
+            Span v;
+            if (env.doc.getString("on", v))
+                on = cmdparse::parseHHMM(v);
+            if (env.doc.getString("off", v))
+                off = cmdparse::parseHHMM(v);
+            d.value = on + off;
+            return on >= 0 && off >= 0;
+        }
+        case CMD_THERMOSTAT:
+        {
+            if (!env.jsonOk)
+                return false;
+            float sp = 0.0f, kp = 0.0f, ki = 0.0f, kd = 0.0f;
+            bool enabled = false;
+            env.doc.getFloat("setpoint", sp);
+            env.doc.getFloat("kp", kp);
+            env.doc.getFloat("ki", ki);
+            env.doc.getFloat("kd", kd);
+            env.doc.getBool("enabled", enabled);
+            d.value = int(sp + kp + ki + kd) + enabled;
+            return true;
+        }
+        case CMD_CAPTURE:
+        {
+            Span chName = tok;
+            float cycles = 0.0f;
+            if (env.json)
+            {
+                if (!env.jsonOk)
+                    return false;
+                chName = Span{"all", 3};
+                env.doc.getString("channel", chName);
+                env.doc.getFloat("cycles", cycles);
+            }
+            char name[16];
+            chName.copyTo(name, sizeof(name));
+            d.value = name[0] + int(cycles);
+            return !chName.empty();
+        }
+        case CMD_PROBES:
+        {
+            if (tokenIs(tok, "rescan"))
+                return true;
+            if (!env.jsonOk)
+                return false;
+            Span slotSpan, romSpan;
+            env.doc.getString("assign", slotSpan);
+            env.doc.getString("rom", romSpan);
+            char slot[16], rom[24];
+            slotSpan.copyTo(slot, sizeof(slot));
+            romSpan.copyTo(rom, sizeof(rom));
+            d.value = slot[0] + rom[0];
+            return slot[0] && rom[0];
+        }
+        default:
+            return false;
+        }
+    }
+
+    // MqttCommandRouter::handle, parse side
+    Decoded handle(const char *topic, const uint8_t *payload, size_t length)
+    {
+        Decoded d;
+        d.cmd = TOPIC_TABLE.find(topic, CMD_UNKNOWN);
+        if (d.cmd == CMD_UNKNOWN)
+            return d;
+
+        Envelope env;
+        env.token = cmdparse::trim(reinterpret_cast<const char *>(payload), length);
+        if (env.token.n && env.token.p[0] == '{')
+        {
+            env.json = true;
+            env.jsonOk = env.doc.parse(payload, length);
+            env.token = Span{};
+            if (env.jsonOk)
+            {
+                env.doc.getScalar("id", env.id);
+                env.doc.getScalar("cmd", env.token);
+            }
+        }
+        d.ok = dispatch(d.cmd, env, d);
+        d.idLen = env.id.n;
+        return d;
+    }
+
+    // Pre-cmdparse shape: String copy + lower-cased copy + strcmp chain
+    Decoded legacyHandle(const char *topic, const uint8_t *payload, size_t length)
+    {
+        Decoded d;
+        const std::string msg(reinterpret_cast<const char *>(payload), length);
+        std::string lower = msg;
+        std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) { return char(std::tolower(c)); });
+
+        for (const cmdparse::Route &r : ROUTES)
+        {
+            if (std::strcmp(topic, r.topic) == 0)
+            {
+                d.cmd = r.id;
+                break;
+            }
+        }
+        switch (d.cmd)
+        {
+        case CMD_FEEDER:
+        case CMD_REBOOT:
+            d.ok = lower == "1" || lower == "feed" || lower == "now";
+            break;
+        case CMD_AUTO_MODE:
+        case CMD_LIGHTS:
+        case CMD_HEAT:
+        case CMD_UV:
+            d.value = lower == "on" ? 1 : lower == "off" ? 0 : -1;
+            d.ok = d.value >= 0;
+            break;
+        case CMD_CAPTURE:
+        case CMD_PROBES:
+        {
+            const std::string arg = lower; // chName / slot copy
+            d.value = arg.empty() ? 0 : arg[0];
+            d.ok = true;
+            break;
+        }
+        default:
+            d.ok = msg.size() > 0 && msg[0] == '{';
+            break;
+        }
+        return d;
+    }
+
+    struct Msg
+    {
+        const char *topic;
+        const char *payload;
+    };
+
+    const Msg TOKENS[] = {
+        {TOPIC_LIGHTS_CMD, "ON"},
+        {TOPIC_HEAT_CMD, "off"},
+        {TOPIC_UV_CMD, " On \n"},
+        {TOPIC_AUTO_MODE_CMD, "off"},
+        {TOPIC_FEEDER_CMD, "feed"},
+        {TOPIC_TEMP_PROBES_CMD, "rescan"},
+        {TOPIC_CURRENT_CAPTURE_CMD, "heat"},
+        {TOPIC_TEMP_BASKING, "81.2"}, // not a command topic
+    };
+    const Msg JSONS[] = {
+        {TOPIC_LIGHTS_SCHEDULE_CMD, "{\"on\":\"07:30\",\"off\":\"19:00\"}"},
+        {TOPIC_HEAT_THERMOSTAT_CMD, "{\"enabled\":true,\"setpoint\":95.5,\"kp\":0.08}"},
+        {TOPIC_CURRENT_CAPTURE_CMD, "{\"channel\":\"uv\",\"cycles\":12}"},
+        {TOPIC_LIGHTS_CMD, "{\"id\":\"a1b2c3\",\"cmd\":\"on\"}"},
+        {TOPIC_TEMP_PROBES_CMD, "{\"assign\":\"water\",\"rom\":\"28FF4A1B93160402\"}"},
+    };
+
+    Decoded run(bool legacy, const Msg &m)
+    {
+        const uint8_t *p = reinterpret_cast<const uint8_t *>(m.payload);
+        const size_t n = std::strlen(m.payload);
+        return legacy ? legacyHandle(m.topic, p, n) : handle(m.topic, p, n);
+    }
+
+    struct Timing
+    {
+        double nsPerMsg;
+        double allocsPerMsg;
+    };
+
+    volatile int sink = 0;
+
+    template <size_t N>
+    Timing bench(bool legacy, const Msg (&set)[N], int iters)
+    {
+        const size_t a0 = allocations;
+        const auto t0 = std::chrono::steady_clock::now();
+        for (int i = 0; i < iters; ++i)
+        {
+            const Decoded d = run(legacy, set[size_t(i) % N]);
+            sink = sink + d.value + d.ok;
+        }
+        const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+        return {ns / iters, double(allocations - a0) / iters};
+    }
+
+    int failures = 0;
+
+    void expect(const Msg &m, uint8_t cmd, bool ok, int value)
+    {
+        const Decoded d = run(false, m);
+        if (d.cmd != cmd || d.ok != ok || (ok && d.value != value))
+        {
+            printf("FAIL %s '%s': cmd %u ok %d value %d\n", m.topic, m.payload, d.cmd, d.ok, d.value);
+            ++failures;
+        }
+    }
+}
+
+int main()
+{
+    expect(TOKENS[0], CMD_LIGHTS, true, 1);
+    expect(TOKENS[2], CMD_UV, true, 1);
+    expect(TOKENS[7], CMD_UNKNOWN, false, 0);
+    expect(JSONS[0], CMD_SCHEDULE, true, 730 + 1900);
+    expect(JSONS[2], CMD_CAPTURE, true, 'u' + 12);
+    expect(JSONS[3], CMD_LIGHTS, true, 1);
+    expect({TOPIC_HEAT_CMD, "maybe"}, CMD_HEAT, false, 0);
+    expect({TOPIC_LIGHTS_SCHEDULE_CMD, "{\"on\":\"25:00\"}"}, CMD_SCHEDULE, false, 0);
+    expect({"turtle/" TOPIC_LIGHTS_CMD, "on"}, CMD_UNKNOWN, false, 0); // root not stripped
+
+    constexpr int ITERS = 2000000;
+    const Msg MIXED[] = {TOKENS[0], TOKENS[1], TOKENS[2], TOKENS[3], JSONS[0], JSONS[1],
+                         TOKENS[4], JSONS[3], TOKENS[5], TOKENS[7]};
+
+    printf("topic table: %zu routes, %u slots, seed %u\n", ROUTE_COUNT, 16u, TOPIC_TABLE.seed);
+    printf("%-12s %12s %12s %14s %14s\n", "traffic", "ns/msg", "allocs/msg", "legacy ns/msg", "legacy allocs");
+    struct
+    {
+        const char *name;
+        Timing now, old;
+    } rows[] = {
+        {"tokens", bench(false, TOKENS, ITERS), bench(true, TOKENS, ITERS)},
+        {"json", bench(false, JSONS, ITERS), bench(true, JSONS, ITERS)},
+        {"mixed", bench(false, MIXED, ITERS), bench(true, MIXED, ITERS)},
+    };
+    bool allocated = false;
+    for (const auto &r : rows)
+    {
+        printf("%-12s %12.1f %12.3f %14.1f %14.3f\n", r.name, r.now.nsPerMsg, r.now.allocsPerMsg, r.old.nsPerMsg,
+               r.old.allocsPerMsg);
+        allocated |= r.now.allocsPerMsg != 0.0;
+    }
+    if (allocated)
+        printf("FAIL dispatch path allocated\n");
+
+    printf("%s (%d failures)\n", failures || allocated ? "FAILED" : "all passed", failures);
+    return failures || allocated ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,97 @@
+// Host-side accuracy / timing bench for HarmonicAnalyzer (src/current_sensor/harmonic_analyzer.h).
+//
+// Build:   g++ -std=c++17 -O2 -DHARMONICS_SCALAR -I../src harmonics_bench.cpp ../src/current_sensor/harmonic_analyzer.cpp -o harmonics_bench
+// Run:     ./harmonics_bench
+//
+// Synthetic lamp: 0.43 A RMS fundamental at 60 Hz with 10 % 3rd, 5 % 5th and
+// 2 % 7th, 2 counts of noise, on the ZMCT103C scaling (GAIN_EIGHT, 0.5 Ω).
+// Reports each harmonic and THD against the truth for capture lengths of
+// 43..256 samples at the nominal 860 SPS and at ±7 % clock error, then the
+// time per analysis with cached tables (same n / rate, the periodic case) and
+// with a table rebuild (rate changed).
+//
+// This runs the scalar dot product only. The esp-dsp path needs the S3: build
+// the firmware with and without -DHARMONICS_SCALAR and compare the boot line
+// "[Current] harmonics: N samples in X us (esp-dsp|scalar)".
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include "current_sensor/harmonic_analyzer.h"
+
+namespace
+{
+    constexpr double PI = 3.14159265358979323846;
+    constexpr float AMPS_PER_COUNT = 1.5625e-5f / 0.5f; // GAIN_EIGHT LSB / burden
+    constexpr float F1_A = 0.43f;
+    constexpr float H3 = 0.10f, H5 = 0.05f, H7 = 0.02f;
+
+    void synth(int16_t *s, uint16_t n, float fs, std::mt19937 &rng)
+    {
+        std::normal_distribution<float> noise(0.0f, 2.0f);
+        const float a1 = F1_A * std::sqrt(2.0f) / AMPS_PER_COUNT;
+        for (uint16_t i = 0; i < n; ++i)
+        {
+            const float w = float(2.0 * PI * 60.0 * i / fs);
+            const float v = 12.0f + a1 * (std::sin(w) + H3 * std::sin(3 * w + 0.3f) +
+                                          H5 * std::sin(5 * w + 1.0f) + H7 * std::sin(7 * w + 2.0f));
+            s[i] = int16_t(std::lround(v + noise(rng)));
+        }
+    }
+
+    uint32_t spanUs(uint16_t n, float fs) { return uint32_t((n - 1) * 1e6 / fs); }
+}
+
+int main()
+{
+    HarmonicAnalyzer a;
+    HarmonicAnalyzer::Result r;
+    std::mt19937 rng(1);
+    int16_t s[HarmonicAnalyzer::MAX_SAMPLES];
+    const float thdTrue = 100.0f * std::sqrt(H3 * H3 + H5 * H5 + H7 * H7);
+
+    printf("truth: f1 %.4f A, h3 %.2f %%, h5 %.2f %%, h7 %.2f %%, THD %.2f %%\n",
+           F1_A, H3 * 100, H5 * 100, H7 * 100, thdTrue);
+    printf("%5s %4s %9s %7s %7s %7s %7s\n", "sps", "n", "f1 A", "h3 %", "h5 %", "h7 %", "THD %");
+    for (float fs : {800.0f, 860.0f, 930.0f})
+    {
+        for (uint16_t n : {43, 86, 172, 256})
+        {
+            synth(s, n, fs, rng);
+            if (!a.analyze(s, n, spanUs(n, fs), 60, AMPS_PER_COUNT, r))
+            {
+                printf("%5.0f %4u  (rejected)\n", fs, n);
+                continue;
+            }
+            printf("%5.0f %4u %9.4f %7.2f %7.2f %7.2f %7.2f\n", fs, n, r.fundamentalA,
+                   100 * r.h3A / r.fundamentalA, 100 * r.h5A / r.fundamentalA, 100 * r.h7A / r.fundamentalA, r.thdPct);
+        }
+    }
+
+    // Timing: cached tables (same n and rate every call)
+    constexpr int ITERS = 200000;
+    const uint16_t n = 86;
+    synth(s, n, 860.0f, rng);
+    float acc = 0.0f;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int k = 0; k < ITERS; ++k)
+    {
+        a.analyze(s, n, spanUs(n, 860.0f), 60, AMPS_PER_COUNT, r);
+        acc += r.thdPct;
+    }
+    const double cached = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count() / ITERS;
+
+    // Timing: rate alternates 860 / 900 SPS, so the cos/sin tables are rebuilt every call
+    t0 = std::chrono::steady_clock::now();
+    for (int k = 0; k < ITERS / 10; ++k)
+    {
+        a.analyze(s, n, spanUs(n, (k & 1) ? 900.0f : 860.0f), 60, AMPS_PER_COUNT, r);
+        acc += r.thdPct;
+    }
+    const double rebuilt = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count() / (ITERS / 10);
+
+    printf("n=%u, %s: %.2f us/analysis (tables cached), %.2f us (tables rebuilt)  [%g]\n", n,
+           HarmonicAnalyzer::vectorized() ? "esp-dsp" : "scalar", cached, rebuilt, double(acc));
+    return 0;
+}
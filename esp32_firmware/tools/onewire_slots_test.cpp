@@ -0,0 +1,130 @@
+// Host-side check of the OneWire RMT slot encoding (src/Temp_sensor/onewire_slots.h).
+//
+// Build:   g++ -std=c++17 -O2 -I../src onewire_slots_test.cpp -o onewire_slots_test
+// Run:     ./onewire_slots_test          (exit status 0 = all passed)
+//
+// Covers what OneWireRmt relies on without a bus attached:
+//  - reset / write-0 / write-1 / read slot shapes against AN126 timings
+//  - byte → 8 write slots (LSB first) and captured read slots → byte, for every
+//    byte value against a simulated slave holding a 0 for 15..60 µs
+//  - presence decode: normal, no device, shorted bus, late presence, glitch
+//  - CRC-8 on the AN27 ROM example and a DS18B20 power-on scratchpad
+
+#include <cstdio>
+#include <cstdlib>
+#include <initializer_list>
+#include "Temp_sensor/onewire_slots.h"
+
+namespace
+{
+    int failures = 0;
+
+#define CHECK(cond)                                                         \
+    do                                                                      \
+    {                                                                       \
+        if (!(cond))                                                        \
+        {                                                                   \
+            printf("FAIL %s:%d  %s\n", __FILE__, __LINE__, #cond);          \
+            ++failures;                                                     \
+        }                                                                   \
+    } while (0)
+
+    // What the RMT receiver captures when a slave answers the master's 8 read
+    // slots with `value`: a 0 bit stretches the low phase to zeroHoldUs, the
+    // slot length stays the master's. The last pulse ends on bus idle.
+    void slaveAnswer(const OwPulse *tx, uint8_t value, uint16_t zeroHoldUs, OwPulse *rx)
+    {
+        for (int i = 0; i < 8; ++i)
+        {
+            const bool one = (value >> i) & 1;
+            const uint16_t low = one ? tx[i].lowUs : zeroHoldUs;
+            rx[i] = {low, uint16_t(tx[i].lowUs + tx[i].highUs - low)};
+        }
+        rx[7].highUs = 0;
+    }
+
+    void testSlotShapes()
+    {
+        const OwPulse reset = owResetPulse();
+        CHECK(reset.lowUs >= 480 && reset.highUs >= 480);
+
+        const OwPulse w0 = owWriteSlot(false), w1 = owWriteSlot(true);
+        CHECK(w0.lowUs >= 60 && w0.lowUs <= 120);
+        CHECK(w1.lowUs >= 1 && w1.lowUs < 15);
+        CHECK(w0.lowUs + w0.highUs >= 60 && w0.lowUs + w0.highUs <= 120);
+        CHECK(w1.lowUs + w1.highUs >= 60 && w1.lowUs + w1.highUs <= 120);
+
+        const OwPulse rd = owReadSlot();
+        CHECK(rd.lowUs == w1.lowUs && rd.highUs == w1.highUs);
+        CHECK(owDecodeBit(rd));                       // nobody pulling: reads 1
+        CHECK(!owDecodeBit({OW_READ_SAMPLE_US, 50})); // held to the sample point: 0
+    }
+
+    void testEncodeByte()
+    {
+        OwPulse tx[8];
+        CHECK(owEncodeByte(0xA5, tx) == 8);
+        const bool expect[8] = {1, 0, 1, 0, 0, 1, 0, 1}; // LSB first
+        for (int i = 0; i < 8; ++i)
+            CHECK((tx[i].lowUs == OW_WRITE1_LOW_US) == expect[i]);
+    }
+
+    void testDecodeByte()
+    {
+        OwPulse rd[8], rx[8];
+        for (OwPulse &p : rd)
+            p = owReadSlot();
+        for (int v = 0; v < 256; ++v)
+        {
+            for (uint16_t hold : {15, 20, 30, 45, 60})
+            {
+                slaveAnswer(rd, uint8_t(v), hold, rx);
+                uint8_t out = 0;
+                CHECK(owDecodeByte(rx, 8, out));
+                if (out != v)
+                {
+                    printf("FAIL byte 0x%02X, hold %u us → 0x%02X\n", v, hold, out);
+                    ++failures;
+                }
+            }
+        }
+        uint8_t out;
+        CHECK(!owDecodeByte(rx, 7, out)); // short capture
+    }
+
+    void testPresence()
+    {
+        const OwPulse present[2] = {{480, 30}, {120, 0}};
+        const OwPulse noDevice[1] = {{480, 0}};
+        const OwPulse shorted[2] = {{5000, 30}, {120, 0}};
+        const OwPulse late[2] = {{480, 90}, {120, 0}};
+        const OwPulse glitch[2] = {{480, 30}, {5, 0}};
+        CHECK(owDecodePresence(present, 2));
+        CHECK(!owDecodePresence(noDevice, 1));
+        CHECK(!owDecodePresence(shorted, 2));
+        CHECK(!owDecodePresence(late, 2));
+        CHECK(!owDecodePresence(glitch, 2));
+    }
+
+    void testCrc8()
+    {
+        // Maxim AN27: family 02, serial 00000001B81C → CRC A2
+        const uint8_t rom[8] = {0x02, 0x1C, 0xB8, 0x01, 0x00, 0x00, 0x00, 0xA2};
+        CHECK(owCrc8(rom, 7) == 0xA2);
+        CHECK(owCrc8(rom, 8) == 0x00);
+        // DS18B20 power-on scratchpad (85 °C)
+        const uint8_t sp[9] = {0x50, 0x05, 0x4B, 0x46, 0x7F, 0xFF, 0x0C, 0x10, 0x1C};
+        CHECK(owCrc8(sp, 8) == sp[8]);
+    }
+}
+
+int main()
+{
+    testSlotShapes();
+    testEncodeByte();
+    testDecodeByte();
+    testPresence();
+    testCrc8();
+    printf("%s (%d failures)\n", failures ? "FAILED" : "all passed", failures);
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,118 @@
+// Host-side decoder for packed telemetry frames (include/telemetry_frame.h) → JSON lines.
+//
+// Build:   g++ -std=c++17 -O2 -I../include telemetry_frame_dump.cpp -o telemetry_frame_dump
+// Record:  mosquitto_sub -h <broker> -t 'turtle/telemetry/frame' -N > frames.bin
+//          (-N: no delimiter, frames are self-delimiting)
+// Decode:  ./telemetry_frame_dump frames.bin        (or pipe into stdin)
+//
+// One JSON object per frame. temps / currents are in TEMP_PROBES /
+// CURRENT_CHANNELS row order; absent probes print null. Sequence gaps (lost
+// frames) and resets (ESP reboot) are reported on stderr.
+
+#include <cstdio>
+#include <cstdint>
+#include <vector>
+#include "telemetry_frame.h"
+
+namespace
+{
+    bool readAll(FILE *f, std::vector<uint8_t> &out)
+    {
+        uint8_t buf[4096];
+        size_t n;
+        while ((n = fread(buf, 1, sizeof(buf), f)) > 0)
+            out.insert(out.end(), buf, buf + n);
+        return !ferror(f);
+    }
+
+    const char *healthName(uint8_t h)
+    {
+        static const char *const names[] = {"learning", "ok", "degrading", "fail"};
+        return h < 4 ? names[h] : "?";
+    }
+
+    void printFrame(const TelemetryFrame &f)
+    {
+        printf("{\"seq\":%u,\"rtc\":%u,\"uptime_s\":%u,\"heap_kb\":%u,\"feed_count\":%u,",
+               f.seq, f.rtcSeconds, f.uptimeS, f.heapKB, f.feedCount);
+        printf("\"lights\":%d,\"heat\":%d,\"uv\":%d,\"auto\":%d,\"feeder_running\":%d,",
+               !!(f.flags & TF_LIGHTS), !!(f.flags & TF_HEAT), !!(f.flags & TF_UV),
+               !!(f.flags & TF_AUTO_MODE), !!(f.flags & TF_FEEDER_RUNNING));
+        if (f.heatDutyPct == TF_HEAT_DUTY_NONE)
+            printf("\"heat_duty\":null,");
+        else
+            printf("\"heat_duty\":%.2f,", f.heatDutyPct / 100.0);
+
+        printf("\"temps\":[");
+        for (uint8_t i = 0; i < f.tempCount; ++i)
+        {
+            const TelemetryFrameTemp &t = f.temps[i];
+            if (!(t.flags & TFT_PRESENT))
+                printf("%snull", i ? "," : "");
+            else
+                printf("%s{\"f\":%.2f,\"slope\":%.2f,\"outlier\":%d,\"rise_alarm\":%d}", i ? "," : "",
+                       t.tempF, t.slopeFPerMin, !!(t.flags & TFT_OUTLIER), !!(t.flags & TFT_RISE_ALARM));
+        }
+        printf("],\"currents\":[");
+        for (uint8_t i = 0; i < f.currentCount; ++i)
+        {
+            const TelemetryFrameCurrent &c = f.currents[i];
+            printf("%s{\"a\":%.3f,\"wh\":%.1f,\"health\":\"%s\",\"powered\":%d,\"ok\":%d}", i ? "," : "",
+                   c.amps, c.energyWh, healthName(c.health),
+                   !!(c.flags & TFC_POWERED), !!(c.flags & TFC_ABOVE_THRESHOLD));
+        }
+        printf("]}\n");
+    }
+}
+
+int main(int argc, char **argv)
+{
+    std::vector<uint8_t> data;
+    if (argc < 2)
+    {
+        if (!readAll(stdin, data))
+            return 1;
+    }
+    for (int a = 1; a < argc; ++a)
+    {
+        FILE *f = fopen(argv[a], "rb");
+        if (!f || !readAll(f, data))
+        {
+            fprintf(stderr, "cannot read %s\n", argv[a]);
+            return 1;
+        }
+        fclose(f);
+    }
+
+    size_t frames = 0;
+    bool haveSeq = false;
+    uint32_t lastSeq = 0;
+    size_t pos = 0;
+    while (pos < data.size())
+    {
+        TelemetryFrame f;
+        const size_t len = telemetryDecodeFrame(data.data() + pos, data.size() - pos, f);
+        if (!len)
+        {
+            ++pos; // resync on the next magic
+            continue;
+        }
+        pos += len;
+        ++frames;
+
+        if (haveSeq && f.seq < lastSeq)
+            fprintf(stderr, "seq %u after %u: device rebooted\n", f.seq, lastSeq);
+        else if (haveSeq && f.seq > lastSeq + 1)
+            fprintf(stderr, "seq %u after %u: %u frame(s) lost\n", f.seq, lastSeq, f.seq - lastSeq - 1);
+        haveSeq = true;
+        lastSeq = f.seq;
+
+        printFrame(f);
+    }
+    if (!frames)
+    {
+        fprintf(stderr, "no telemetry frames found\n");
+        return 1;
+    }
+    return 0;
+}
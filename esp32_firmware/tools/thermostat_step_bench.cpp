@@ -0,0 +1,181 @@
+// Host-side step-response bench for HeatThermostat (src/lights/heat_thermostat.h)
+// against a simulated basking spot.
+//
+// Build:   g++ -std=c++17 -O2 -I../src thermostat_step_bench.cpp ../src/lights/heat_thermostat.cpp ../src/Temp_sensor/temp_estimator.cpp -o thermostat_step_bench
+// Run:     ./thermostat_step_bench           (add -v for a 10-minute trace of the default gains)
+//
+// Plant: first order, the lamp adds K = 40 °F at full power, tau = 8 min, plus a
+// 30 s transport delay (lamp → rock → probe). The controller sees the plant
+// the way the firmware does: a reading every 3 s at 10-bit resolution
+// (0.25 °C) with noise, through TempEstimator. 4 h runs: 75 °F room, the room
+// steps to 88 °F at 2 h.
+//
+// Reported per gain set: time from 75 °F to within 1 °F of the setpoint,
+// start-up overshoot, steady-state mean and relay ripple (1.5..2 h), the peak
+// after the ambient step and how long until it stays within 2 °F, and lamp
+// switch-ons per hour. The open-loop row is the old behaviour (lamp on for the
+// whole schedule window).
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <random>
+#include "lights/heat_thermostat.h"
+#include "Temp_sensor/temp_estimator.h"
+
+namespace
+{
+    constexpr float ROOM_F = 75.0f;
+    constexpr float ROOM_STEP_F = 88.0f;
+    constexpr int RUN_S = 4 * 3600;
+    constexpr int STEP_AT_S = 2 * 3600;
+    constexpr int READ_EVERY_S = 3;
+    constexpr float BAND_F = 1.0f;        // rise: within 1 °F of the setpoint
+    constexpr float SETTLE_BAND_F = 2.0f; // after the step; wider than the relay ripple
+
+    struct Plant
+    {
+        float tempF = ROOM_F;
+        float ambientF = ROOM_F;
+        float gainF = 40.0f;  // full power, steady state above ambient
+        float tauMin = 8.0f;
+        int delayS = 30;
+        std::deque<bool> pipe; // lamp state, delayed
+
+        float step(bool lamp, float dtS)
+        {
+            pipe.push_back(lamp);
+            bool u = false;
+            if (int(pipe.size()) > delayS)
+            {
+                u = pipe.front();
+                pipe.pop_front();
+            }
+            tempF += (ambientF + (u ? gainF : 0.0f) - tempF) * (dtS / 60.0f) / tauMin;
+            return tempF;
+        }
+    };
+
+    struct Result
+    {
+        float riseMin = -1.0f;
+        float overshootF = 0.0f;
+        float steadyMeanF = 0.0f;
+        float rippleF = 0.0f;
+        float stepPeakF = 0.0f;
+        float stepSettleMin = -1.0f;
+        float cyclesPerHour = 0.0f;
+    };
+
+    Result run(const HeatThermostat::Tuning &tune, bool closedLoop, bool trace)
+    {
+        HeatThermostat th(tune, HeatThermostat::Config{});
+        TempEstimator::Config ec;
+        const float q = 0.25f; // 10-bit step, °C
+        ec.measSigmaC = std::sqrt(0.01f + q * q / 12.0f);
+        TempEstimator est(ec);
+
+        Plant p;
+        std::mt19937 rng(3);
+        std::normal_distribution<float> noiseC(0.0f, 0.1f);
+
+        Result r;
+        float steadyMin = 1e9f, steadyMax = -1e9f, steadySum = 0.0f;
+        int steadyN = 0, cycles = 0, lastOutS = STEP_AT_S;
+        bool lastRelay = false;
+
+        for (int s = 0; s < RUN_S; ++s)
+        {
+            if (s == STEP_AT_S)
+                p.ambientF = ROOM_STEP_F;
+
+            if (s % READ_EVERY_S == 0)
+            {
+                float c = (p.tempF - 32.0f) / 1.8f + noiseC(rng);
+                c = std::round(c / q) * q;
+                est.update(c, READ_EVERY_S / 60.0f);
+            }
+            const float tf = est.tempC() * 1.8f + 32.0f;
+            const float slope = est.isWarm() ? est.slopeCPerMin() * 1.8f : 0.0f;
+            const bool relay = closedLoop ? th.update(uint32_t(s) * 1000u, tf, slope, est.isInitialised()) : true;
+            if (relay && !lastRelay)
+                ++cycles;
+            lastRelay = relay;
+
+            const float t = p.step(relay, 1.0f);
+            const float err = t - tune.setpointF;
+            if (r.riseMin < 0.0f && err >= -BAND_F)
+                r.riseMin = s / 60.0f;
+            if (s < STEP_AT_S)
+                r.overshootF = std::fmax(r.overshootF, err);
+            if (s >= STEP_AT_S * 3 / 4 && s < STEP_AT_S)
+            {
+                steadyMin = std::fmin(steadyMin, t);
+                steadyMax = std::fmax(steadyMax, t);
+                steadySum += t;
+                ++steadyN;
+            }
+            if (s >= STEP_AT_S)
+            {
+                r.stepPeakF = std::fmax(r.stepPeakF, t);
+                if (std::fabs(err) > SETTLE_BAND_F)
+                    lastOutS = s;
+            }
+            if (trace && s % 600 == 0)
+                printf("  t=%3d min  T=%.1f F  duty=%.2f  I=%.2f  %s\n", s / 60, t, th.duty(), th.integral(),
+                       HeatThermostat::toString(th.mode()));
+        }
+        r.steadyMeanF = steadyN ? steadySum / steadyN : 0.0f;
+        r.rippleF = steadyMax - steadyMin;
+        r.stepSettleMin = (lastOutS - STEP_AT_S) / 60.0f;
+        r.cyclesPerHour = cycles / (RUN_S / 3600.0f);
+        return r;
+    }
+
+    void print(const char *name, const HeatThermostat::Tuning &t, const Result &r)
+    {
+        printf("%-10s %5.2f %6.3f %5.2f | %6.1f %6.1f %7.1f %6.2f | %6.1f %6.1f | %5.1f\n", name, t.kp, t.ki, t.kd,
+               r.riseMin, r.overshootF, r.steadyMeanF, r.rippleF, r.stepPeakF, r.stepSettleMin, r.cyclesPerHour);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    const bool verbose = argc > 1 && std::strcmp(argv[1], "-v") == 0;
+
+    struct
+    {
+        const char *name;
+        float kp, ki, kd;
+    } sets[] = {
+        {"default", 0.08f, 0.01f, 0.0f},
+        {"low", 0.04f, 0.005f, 0.0f},
+        {"high-kp", 0.20f, 0.05f, 0.0f},
+        {"pid", 0.12f, 0.015f, 0.3f},
+    };
+
+    printf("setpoint 95 F, room 75 F -> 88 F at 2 h\n");
+    printf("%-10s %5s %6s %5s | %6s %6s %7s %6s | %6s %6s | %5s\n", "gains", "kp", "ki", "kd",
+           "rise", "oversh", "steady", "ripple", "stepPk", "settle", "cyc/h");
+    printf("%-10s %5s %6s %5s | %6s %6s %7s %6s | %6s %6s | %5s\n", "", "", "", "",
+           "min", "F", "F", "F", "F", "min", "");
+
+    const HeatThermostat::Tuning defaults;
+    print("open-loop", defaults, run(defaults, false, false));
+    for (const auto &g : sets)
+    {
+        HeatThermostat::Tuning t;
+        t.kp = g.kp;
+        t.ki = g.ki;
+        t.kd = g.kd;
+        print(g.name, t, run(t, true, false));
+    }
+
+    if (verbose)
+    {
+        printf("\ndefault gains, every 10 min:\n");
+        run(defaults, true, true);
+    }
+    return 0;
+}
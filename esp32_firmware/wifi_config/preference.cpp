@@ -18,6 +18,17 @@ void setup()
 
     // Close Preferences
     preferences.end();
+
+    // Device identity / broker (mqtt/device_config.h). Each tank on a shared
+    // broker needs its own root; unset keys keep the defaults.
+    preferences.begin("device", false);
+    // preferences.putString("id", "turtle-tank2");
+    // preferences.putString("root", "turtle/tank2/");
+    // preferences.putString("host", "172.22.80.5");
+    // preferences.putUShort("port", 1883);
+    // preferences.putString("user", "");
+    // preferences.putString("pass", "");
+    preferences.end();
 }
 
 void loop()
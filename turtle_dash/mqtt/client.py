@@ -6,11 +6,14 @@ import paho.mqtt.client as mqtt
 from mqtt.sensors import Sensor
 from mqtt.status_manager import status, StatusManager
 from mqtt.topics import TOPICS
+from mqtt import telemetry_frame
+from services.replay_ingest import ReplayIngest
 
 # ————————————————————————————————
 # 1) Your sensors and status manager
 basking_sensor = Sensor("Basking", default=0, valid_range=(40, 130))
 water_sensor  = Sensor("Water",  default=0, valid_range=(40, 130))
+replay_ingest = ReplayIngest(interval_s=1800)
 
 # ————————————————————————————————
 # 2) MQTT callbacks
@@ -26,6 +29,11 @@ def on_message(client, userdata, msg):
         # every message is a heartbeat
         status.update_status("mqtt_status", "connected")
 
+        # Binary: handle before the text decode below
+        if msg.topic == "turtle/telemetry/frame":
+            apply_frame(telemetry_frame.decode(msg.payload))
+            return
+
         topic, payload = msg.topic, msg.payload.decode()
 
         if topic == "turtle/sensors/temp/basking":
@@ -34,6 +42,9 @@ def on_message(client, userdata, msg):
         if topic == "turtle/sensors/temp/water":
             water_sensor.update(float(payload))
             return
+        if topic == "turtle/replay/telemetry":
+            replay_ingest.handle(payload)
+            return
 
         # inside on_message, before the mapping:
         if topic == "turtle/lights/schedule":
@@ -72,6 +83,7 @@ def on_message(client, userdata, msg):
             "turtle/esp/heap":               ("heap", int),
             "turtle/esp/uptime_ms":          ("esp_uptime_ms", int),
             "turtle/esp/mqtt":               ("esp_mqtt", str),
+            "turtle/esp/replay":             ("esp_replay", str),
 
             # Currents (new paths)
             "turtle/sensors/current/heat":   ("heat_bulb_current", float),
@@ -94,6 +106,32 @@ def on_message(client, userdata, msg):
         # Log and swallow any errors so the thread never dies
         print(f"[MQTT:on_message] Error parsing {msg.topic}: {e}")
 
+def apply_frame(frame):
+    """Populate sensors + status from one packed frame (cold start: one retained message)."""
+    if frame is None:
+        return
+    temps = frame["temps"]
+    if "basking" in temps:
+        basking_sensor.update(round(temps["basking"]["f"], 1))
+    if "water" in temps:
+        water_sensor.update(round(temps["water"]["f"], 1))
+
+    on_off = lambda b: "ON" if b else "OFF"
+    status.update_status("light_status", on_off(frame["lights"]))
+    status.update_status("heat_bulb_status", on_off(frame["heat"]))
+    status.update_status("uv_bulb_status", on_off(frame["uv"]))
+    status.update_status("feeder_state", "RUNNING" if frame["feeder_running"] else "IDLE")
+    status.update_status("feed_count", frame["feed_count"])
+    status.update_status("auto_mode", "on" if frame["auto_mode"] else "off")
+    status.update_status("heap", f"{frame['heap_kb']} KB")  # same text as turtle/esp/heap
+    status.update_status("esp_uptime_ms", frame["uptime_s"] * 1000)
+    for name, c in frame["currents"].items():
+        status.update_status(f"{name}_bulb_current", round(c["a"], 2))
+        if c["powered"]:
+            status.update_status(f"{name}_bulb_current_status", "OK" if c["ok"] else "FLT")
+        else:
+            status.update_status(f"{name}_bulb_current_status", "OFF")
+
 def on_disconnect(client, userdata, *args):
     """
     Called whenever the MQTT client loses its connection.
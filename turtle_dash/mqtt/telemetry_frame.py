@@ -0,0 +1,69 @@
+# mqtt/telemetry_frame.py
+#
+# Decoder for the ESP's packed telemetry frame (turtle/telemetry/frame).
+# Layout: esp32_firmware/include/telemetry_frame.h (little-endian, version 1).
+import struct
+
+FRAME_VERSION = 1
+_HEADER = struct.Struct("<2sBBIIIHHBBBx")   # 24 bytes
+_TEMP = struct.Struct("<hhBx")             # 6 bytes
+_CURRENT = struct.Struct("<ffBB")          # 10 bytes
+
+# Row order of TEMP_PROBES / CURRENT_CHANNELS in the firmware
+TEMP_NAMES = ["basking", "water", "cool", "ambient"]
+CURRENT_NAMES = ["heat", "uv"]
+HEALTH_NAMES = ["learning", "ok", "degrading", "fail"]
+
+
+def decode(payload):
+    """Return the frame as a dict, or None if it isn't a v1 frame."""
+    if len(payload) < _HEADER.size:
+        return None
+    (magic, version, flags, seq, rtc, uptime_s, heap_kb, feed_count,
+     heat_duty, n_temps, n_currents) = _HEADER.unpack_from(payload, 0)
+    if magic != b"TM" or version != FRAME_VERSION:
+        return None
+    if len(payload) < _HEADER.size + n_temps * _TEMP.size + n_currents * _CURRENT.size:
+        return None
+
+    frame = {
+        "seq": seq,
+        "rtc": rtc,
+        "uptime_s": uptime_s,
+        "heap_kb": heap_kb,
+        "feed_count": feed_count,
+        "lights": bool(flags & 0x01),
+        "heat": bool(flags & 0x02),
+        "uv": bool(flags & 0x04),
+        "auto_mode": bool(flags & 0x08),
+        "feeder_running": bool(flags & 0x10),
+        "thermostat": bool(flags & 0x20),
+        "heat_duty": None if heat_duty == 255 else heat_duty / 100.0,
+        "temps": {},
+        "currents": {},
+    }
+
+    off = _HEADER.size
+    for i in range(n_temps):
+        temp, slope, tflags = _TEMP.unpack_from(payload, off)
+        off += _TEMP.size
+        name = TEMP_NAMES[i] if i < len(TEMP_NAMES) else f"probe{i}"
+        if tflags & 0x01:
+            frame["temps"][name] = {
+                "f": temp / 100.0,
+                "slope": slope / 100.0,
+                "outlier": bool(tflags & 0x02),
+                "rise_alarm": bool(tflags & 0x04),
+            }
+    for i in range(n_currents):
+        amps, wh, health, cflags = _CURRENT.unpack_from(payload, off)
+        off += _CURRENT.size
+        name = CURRENT_NAMES[i] if i < len(CURRENT_NAMES) else f"ch{i}"
+        frame["currents"][name] = {
+            "a": amps,
+            "wh": wh,
+            "health": HEALTH_NAMES[health] if health < len(HEALTH_NAMES) else "?",
+            "powered": bool(cflags & 0x01),
+            "ok": bool(cflags & 0x02),
+        }
+    return frame
@@ -28,4 +28,11 @@ TOPICS = [
     "turtle/esp/heap",
     "turtle/esp/uptime_ms",
     "turtle/esp/mqtt",
+    "turtle/esp/replay",             # store-and-forward depth / throughput (JSON)
+
+    # Packed frame with every field (retained): full state in one message
+    "turtle/telemetry/frame",
+
+    # Store-and-forward replay after a broker outage
+    "turtle/replay/telemetry",
 ]
@@ -0,0 +1,49 @@
+import json
+import threading
+from datetime import datetime, timezone
+from services.db.database import Database
+
+db = Database()
+
+
+class ReplayIngest:
+    """
+    Fills temperature_log gaps from the ESP's store-and-forward replay
+    (turtle/replay/telemetry). Records arrive oldest-first as
+    [ts, name, value]; ts is RTC seconds and the RTC keeps local time, so it
+    is formatted as UTC to get the wall-clock string the live logger writes.
+    Rows are thinned to the live logger's interval.
+    """
+
+    def __init__(self, interval_s=1800):
+        self.interval = interval_s
+        self._lock = threading.Lock()
+        self._pending = {}   # ts -> {"basking": v, "water": v}
+        self._last_ts = 0
+
+    def handle(self, payload):
+        try:
+            records = json.loads(payload).get("r", [])
+        except Exception as e:
+            print(f"[Replay] bad payload: {e}")
+            return
+
+        with self._lock:
+            for ts, name, value in records:
+                if name not in ("basking", "water"):
+                    continue
+                row = self._pending.setdefault(int(ts), {})
+                row[name] = float(value)
+                if "basking" in row and "water" in row:
+                    del self._pending[int(ts)]
+                    self._insert(int(ts), row)
+            # Samples of one tick share a ts; anything older never completes
+            for ts in [t for t in self._pending if t < self._last_ts]:
+                del self._pending[ts]
+
+    def _insert(self, ts, row):
+        if self._last_ts and abs(ts - self._last_ts) < self.interval:
+            return
+        self._last_ts = ts
+        stamp = datetime.fromtimestamp(ts, timezone.utc).strftime("%Y-%m-%d %H:%M:%S")
+        db.insert_temperature(row["basking"], row["water"], stamp)